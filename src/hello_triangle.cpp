@@ -2,6 +2,69 @@
 #include <kitsune_types.h>
 #include <kitsune_windowing.hpp>
 #include <kitsune_engine.hpp>
+#include <kitsune_readback.hpp>
+#include <kitsune_gpu_timer.hpp>
+#include <kitsune_trace.hpp>
+#include <kitsune_dynamic_resolution.hpp>
+#include <kitsune_render_queue.hpp>
+#include <kitsune_command_cache.hpp>
+
+// Swapchain and per-window state. Target i renders into window i of KitsuneWindowing
+// and presents through engine.resorces.surfaces[i].
+struct WindowTarget
+{
+    uint32_t windowIndex{ 0 };
+
+    std::optional<vk::raii::SwapchainKHR> vkSwapchain{};
+    std::vector<vk::Image> swapchainImages;
+    std::vector<vk::raii::ImageView> swapchainImageViews;
+    vk::Format swapchainFormat{ vk::Format::eUndefined };
+    vk::Extent2D swapchainExtent{ 0, 0 };
+    bool canCaptureSwapchain{ false };
+    // Incremented on every swapchain (re)creation; part of the cached scene pass key.
+    uint64_t swapchainVersion{ 0 };
+
+    // Offscreen scene color target. It is allocated for the largest extent the window can
+    // reach and rendered through a scaled sub-region, then upscaled into the swapchain image.
+    std::optional<vk::raii::Image> sceneImage{};
+    std::optional<KitsuneAllocation> sceneMemory{};
+    std::optional<vk::raii::ImageView> sceneImageView{};
+    vk::Extent2D sceneCapacity{ 0, 0 };
+    vk::Extent2D renderExtent{ 0, 0 };
+    bool canBlitToSwapchain{ false };
+
+    // One per frame in flight; every window acquires with its own semaphore.
+    std::vector<vk::raii::Semaphore> imageAvailableSemaphores;
+
+    vk::Extent2D windowExtent{ 800, 600 };
+    bool isRenderingEnabled{ false };
+    bool isAcquired{ false };
+    uint32_t currentImage{ 0 };
+
+    // Hidden or fully covered by other windows; presenting would only burn power.
+    bool isOccluded{ false };
+
+    bool CanRender() const { return isRenderingEnabled && !isOccluded && windowExtent.width > 0 && windowExtent.height > 0; }
+};
+
+// Where the last recorded command left an image, for chaining barriers.
+struct ImageState
+{
+    vk::ImageLayout layout{ vk::ImageLayout::eUndefined };
+    vk::AccessFlags2 access{ vk::AccessFlagBits2::eNone };
+    vk::PipelineStageFlags2 stage{ vk::PipelineStageFlagBits2::eTopOfPipe };
+};
+
+// Continuous renders every loop iteration. OnDemand renders only after MarkDirty() or a window
+// change, and otherwise blocks in SDL_WaitEventTimeout like the idle path.
+enum class RenderMode
+{
+    Continuous,
+    OnDemand
+};
+
+// Longest the main loop sleeps without events while idle, so Update() still ticks.
+static constexpr int32_t IDLE_WAIT_TIMEOUT_MS = 250;
 
 class HelloTriangle {
 
@@ -9,54 +72,73 @@ class HelloTriangle {
     // SDL and Window
     KitsuneWindowing windowing;
     KitsuneEngine engine{ windowing };
+    KitsuneReadback readback{ engine };
+    KitsuneGpuTimer gpuTimer{ engine };
+    KitsuneDynamicResolution dynamicResolution;
     std::string basePath;
+    uint32_t windowCount{ 1 };
 
 
 
-    // Swapchain and Related Resources
-    std::optional<vk::raii::SwapchainKHR> vkSwapchain{};
-    std::vector<vk::Image> swapchainImages;
-    std::vector<vk::raii::ImageView> swapchainImageViews;
-    vk::Format swapchainFormat{ vk::Format::eUndefined };
-    vk::Extent2D swapchainExtent{ 0, 0 };
+    // Swapchains and Related Resources
+    std::vector<WindowTarget> targets;
 
     // Rendering Resources
+    bool canUseSceneTargets{ false };
+    vk::Filter upscaleFilter{ vk::Filter::eLinear };
     std::optional<vk::raii::PipelineLayout> vkPipelineLayout{};
     std::optional<vk::raii::Pipeline> vkGraphicsPipeline{};
+    KitsuneRenderQueue renderQueue;
+    KitsuneCommandCache commandCache{ engine };
+    bool useCommandCache{ true };
 
     // Command and Synchronization Objects
     std::optional<vk::raii::CommandPool> vkCommandPool{};
     std::vector<vk::raii::CommandBuffer> commandBuffers;
-    std::vector<vk::raii::Semaphore> imageAvailableSemaphores;
     std::vector<vk::raii::Semaphore> renderFinishedSemaphores;
     std::vector<vk::raii::Fence> inFlightFences;
 
     // Runtime State
-    vk::Extent2D windowExtent{ 800, 600 };
     bool isRunning{ true };
     bool isFramebufferResized{ false };
-    bool isRenderingEnabled{ false };
+    RenderMode renderMode{ RenderMode::Continuous };
+    bool isDirty{ true };
+    bool hasFramesInFlight{ false };
     uint32_t currentFrame{ 0 };
-    uint32_t currentImage{ 0 };
+    uint64_t frameNumber{ 0 };
+    std::array<uint64_t, MAX_FRAMES_IN_FLIGHT> slotFrameNumbers{};
     bool useVsync{ true };
     bool hasPortability{ false };
     bool hasDebugUtils{ false };
 
 
 public:
-    HelloTriangle() = default;
+    explicit HelloTriangle(uint32_t windowCount = 1, RenderMode renderMode = RenderMode::Continuous)
+        : windowCount(std::max(windowCount, 1u)), renderMode(renderMode) {}
     ~HelloTriangle() { cleanup(); }
 
     void initialize() {
+        KITSUNE_TRACE_THREAD_NAME("Main");
+        KITSUNE_TRACE_ZONE("Init");
         initializeSDL();
         initializeVulkan();
     }
 
-    void run() 
+    void SetRenderMode(RenderMode mode) {
+        renderMode = mode;
+        MarkDirty();
+    }
+
+    // Requests a frame in RenderMode::OnDemand. Has no effect in continuous mode.
+    void MarkDirty() { isDirty = true; }
+
+    void run()
     {
-        windowing.ShowWindow();
+        for (auto& target : targets) {
+            windowing.ShowWindow(target.windowIndex);
+            target.isRenderingEnabled = true;
+        }
         windowing.MaximizeWindow();
-        isRenderingEnabled = true;
 
         // Calculate deltaTime
         Uint64 NOW = SDL_GetPerformanceCounter();
@@ -64,20 +146,37 @@ public:
         double deltaTime = 0;
 
         while (isRunning) {
-            processEvents();
+            if (!shouldRenderFrame()) {
+                // Nothing will be submitted for a while; finish the frames in flight so their
+                // retired objects and readbacks are released before the loop goes to sleep.
+                completeFramesInFlight();
+                processEvents(true);
+            }
+            else {
+                processEvents(false);
+            }
 
             LAST = NOW;
             NOW = SDL_GetPerformanceCounter();
             deltaTime = (double)((NOW - LAST)*1000 / (double)SDL_GetPerformanceFrequency() );
 
             Update(deltaTime);
-            
-            if (windowExtent.width > 0 && windowExtent.height > 0 && isRenderingEnabled) {
-                renderFrame();
+
+            if (shouldRenderFrame()) {
+                try {
+                    renderFrame();
+                }
+                catch (const vk::DeviceLostError&) {
+                    // Leave a record of what was resident when the device went away.
+                    engine.GetMemory().LogStats();
+                    throw;
+                }
             }
         }
-        
+
         engine.WaitForIdle();
+        engine.FlushRetired();
+        readback.OnDeviceIdle();
     }
 
 private:
@@ -88,48 +187,80 @@ private:
 
     // Initialization Methods
     void initializeSDL() {
+        KITSUNE_TRACE_FUNCTION();
         windowing.init();
+        for (uint32_t i = 1; i < windowCount; ++i) {
+            windowing.AddWindow(fmt::format("{} - Viewport {}", ENGINE_NAME, i + 1), 960, 540);
+        }
 
-        windowExtent = windowing.GetWindowExtent();
+        targets.resize(windowing.GetWindowCount());
+        for (uint32_t i = 0; i < targets.size(); ++i) {
+            targets[i].windowIndex = i;
+            targets[i].windowExtent = windowing.GetWindowExtent(i);
+        }
 
         basePath = SDL_GetBasePath() ? SDL_GetBasePath() : "./";
         fmt::println("Base path: {}", basePath);
+
+        readback.AddSink(MakeRawFileSink(basePath + "captures"));
     }
 
     void initializeVulkan() {
+        KITSUNE_TRACE_FUNCTION();
         engine.Init();
-
+        gpuTimer.Init();
 
         createCommandPool();
-        createSwapchain();
-        createImageViews();
+        for (auto& target : targets) {
+            createSwapchain(target);
+            createImageViews(target);
+        }
+        checkSceneTargetSupport();
+        for (auto& target : targets) {
+            createSceneTarget(target);
+        }
         createGraphicsPipeline();
+        buildRenderQueue();
+        commandCache.Init(static_cast<uint32_t>(targets.size()));
         createSynchronizationObjects();
         createCommandBuffers();
     }
 
     void Update(double deltaTime) {
+        KITSUNE_TRACE_FUNCTION();
         // Update logic here
     }
 
 
 
     void createCommandPool() {
+        KITSUNE_TRACE_FUNCTION();
         vk::CommandPoolCreateInfo poolInfo{};
         poolInfo.setQueueFamilyIndex(*engine.GetQueueFamilyIndices().graphics)
             .setFlags(vk::CommandPoolCreateFlagBits::eResetCommandBuffer);
         vkCommandPool.emplace(*engine.resorces.device, poolInfo);
     }
 
-    void createSwapchain() {
-        vk::SurfaceCapabilitiesKHR capabilities = engine.resorces.physicalDevice->getSurfaceCapabilitiesKHR(*engine.resorces.surface);
-        auto formats = engine.resorces.physicalDevice->getSurfaceFormatsKHR(*engine.resorces.surface);
-        auto presentModes = engine.resorces.physicalDevice->getSurfacePresentModesKHR(*engine.resorces.surface);
+    void createSwapchain(WindowTarget& target, vk::SwapchainKHR oldSwapchain = nullptr) {
+        KITSUNE_TRACE_FUNCTION();
+        ++target.swapchainVersion;
+        const vk::raii::SurfaceKHR& surface = engine.resorces.surfaces[target.windowIndex];
+        vk::SurfaceCapabilitiesKHR capabilities = engine.resorces.physicalDevice->getSurfaceCapabilitiesKHR(*surface);
+        auto formats = engine.resorces.physicalDevice->getSurfaceFormatsKHR(*surface);
+        auto presentModes = engine.resorces.physicalDevice->getSurfacePresentModesKHR(*surface);
 
         vk::SurfaceFormatKHR surfaceFormat = chooseSwapchainFormat(formats);
-        swapchainFormat = surfaceFormat.format; // Extract vk::Format
+        // Every window shares the one graphics pipeline, so every swapchain must use its format.
+        if (&target != &targets.front() && surfaceFormat.format != targets.front().swapchainFormat) {
+            throw std::runtime_error("Window surfaces do not share a common swapchain format");
+        }
+        target.canCaptureSwapchain = static_cast<bool>(capabilities.supportedUsageFlags & vk::ImageUsageFlagBits::eTransferSrc) &&
+            IsReadbackFormatSupported(surfaceFormat.format);
+        if (target.windowIndex == 0 && !target.canCaptureSwapchain) readback.CancelCapture();
+        target.canBlitToSwapchain = static_cast<bool>(capabilities.supportedUsageFlags & vk::ImageUsageFlagBits::eTransferDst);
+        target.swapchainFormat = surfaceFormat.format; // Extract vk::Format
         vk::PresentModeKHR presentMode = choosePresentMode(presentModes);
-        swapchainExtent = chooseSwapchainExtent(capabilities);
+        target.swapchainExtent = chooseSwapchainExtent(capabilities, target.windowIndex);
 
         uint32_t imageCount = capabilities.minImageCount == 1 ? 2 : capabilities.minImageCount;
         if (capabilities.maxImageCount > 0 && imageCount > capabilities.maxImageCount) {
@@ -137,17 +268,18 @@ private:
         }
 
         vk::SwapchainCreateInfoKHR createInfo{};
-        createInfo.setSurface(*engine.resorces.surface)
+        createInfo.setSurface(*surface)
             .setMinImageCount(imageCount)
-            .setImageFormat(swapchainFormat)
+            .setImageFormat(target.swapchainFormat)
             .setImageColorSpace(surfaceFormat.colorSpace) // Use colorSpace from surfaceFormat
-            .setImageExtent(swapchainExtent)
+            .setImageExtent(target.swapchainExtent)
             .setImageArrayLayers(1)
-            .setImageUsage(vk::ImageUsageFlagBits::eColorAttachment)
+            .setImageUsage(getSwapchainUsage(target))
             .setPreTransform(capabilities.currentTransform)
             .setCompositeAlpha(vk::CompositeAlphaFlagBitsKHR::eOpaque)
             .setPresentMode(presentMode)
-            .setClipped(true);
+            .setClipped(true)
+            .setOldSwapchain(oldSwapchain);
 
         std::array<uint32_t, 2> queueIndices = { *engine.GetQueueFamilyIndices().graphics, *engine.GetQueueFamilyIndices().present };
         if (engine.GetQueueFamilyIndices().graphics != engine.GetQueueFamilyIndices().present) {
@@ -159,27 +291,100 @@ private:
             createInfo.setImageSharingMode(vk::SharingMode::eExclusive);
         }
 
-        vkSwapchain.emplace(*engine.resorces.device, createInfo);
-        swapchainImages = vkSwapchain->getImages();
+        target.vkSwapchain.emplace(*engine.resorces.device, createInfo);
+        target.swapchainImages = target.vkSwapchain->getImages();
     }
 
-    void createImageViews() {
-        swapchainImageViews.clear();
-        swapchainImageViews.reserve(swapchainImages.size());
+    void createImageViews(WindowTarget& target) {
+        KITSUNE_TRACE_FUNCTION();
+        target.swapchainImageViews.clear();
+        target.swapchainImageViews.reserve(target.swapchainImages.size());
         vk::ImageViewCreateInfo viewInfo{};
         viewInfo.setViewType(vk::ImageViewType::e2D)
-            .setFormat(swapchainFormat)
+            .setFormat(target.swapchainFormat)
             .setSubresourceRange({ vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1 });
 
-        for (const auto& image : swapchainImages) {
+        for (const auto& image : target.swapchainImages) {
             viewInfo.setImage(image);
-            swapchainImageViews.emplace_back(*engine.resorces.device, viewInfo);
+            target.swapchainImageViews.emplace_back(*engine.resorces.device, viewInfo);
+        }
+    }
+
+
+
+    vk::ImageUsageFlags getSwapchainUsage(const WindowTarget& target) const {
+        vk::ImageUsageFlags usage = vk::ImageUsageFlagBits::eColorAttachment;
+        if (target.canCaptureSwapchain) usage |= vk::ImageUsageFlagBits::eTransferSrc;
+        if (target.canBlitToSwapchain) usage |= vk::ImageUsageFlagBits::eTransferDst;
+        return usage;
+    }
+
+    void checkSceneTargetSupport() {
+        vk::FormatProperties properties = engine.resorces.physicalDevice->getFormatProperties(targets.front().swapchainFormat);
+        vk::FormatFeatureFlags required = vk::FormatFeatureFlagBits::eColorAttachment | vk::FormatFeatureFlagBits::eBlitSrc | vk::FormatFeatureFlagBits::eBlitDst;
+        canUseSceneTargets = (properties.optimalTilingFeatures & required) == required;
+        upscaleFilter = (properties.optimalTilingFeatures & vk::FormatFeatureFlagBits::eSampledImageFilterLinear)
+            ? vk::Filter::eLinear : vk::Filter::eNearest;
+        if (!canUseSceneTargets) {
+            fmt::println("Swapchain format cannot be blitted, dynamic resolution disabled");
+            dynamicResolution.SetEnabled(false);
         }
     }
 
+    // Allocates once at the largest display size so resolution changes never reallocate.
+    // Only a window that outgrows every display (or the first swapchain) triggers a new image.
+    void createSceneTarget(WindowTarget& target) {
+        KITSUNE_TRACE_FUNCTION();
+        if (!canUseSceneTargets || !target.canBlitToSwapchain) return;
+
+        vk::Extent2D displayExtent = windowing.GetMaxDisplayExtent();
+        vk::Extent2D required{
+            std::max(displayExtent.width, target.swapchainExtent.width),
+            std::max(displayExtent.height, target.swapchainExtent.height) };
+        if (target.sceneImage && target.sceneCapacity.width >= target.swapchainExtent.width &&
+            target.sceneCapacity.height >= target.swapchainExtent.height) {
+            return;
+        }
+
+        if (target.sceneImage) {
+            engine.Retire(std::move(*target.sceneImageView));
+            engine.Retire(std::move(*target.sceneImage));
+            engine.Retire(std::move(*target.sceneMemory));
+            target.sceneImageView.reset();
+            target.sceneImage.reset();
+            target.sceneMemory.reset();
+        }
+
+        vk::ImageCreateInfo imageInfo{};
+        imageInfo.setImageType(vk::ImageType::e2D)
+            .setFormat(target.swapchainFormat)
+            .setExtent({ required.width, required.height, 1 })
+            .setMipLevels(1)
+            .setArrayLayers(1)
+            .setSamples(vk::SampleCountFlagBits::e1)
+            .setTiling(vk::ImageTiling::eOptimal)
+            .setUsage(vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransferSrc)
+            .setSharingMode(vk::SharingMode::eExclusive)
+            .setInitialLayout(vk::ImageLayout::eUndefined);
+        target.sceneImage.emplace(*engine.resorces.device, imageInfo);
+
+        target.sceneMemory.emplace(engine.AllocateMemory(target.sceneImage->getMemoryRequirements(),
+            vk::MemoryPropertyFlagBits::eDeviceLocal, MemoryCategory::RenderTargets));
+        target.sceneImage->bindMemory(*target.sceneMemory->GetMemory(), 0);
 
+        vk::ImageViewCreateInfo viewInfo{};
+        viewInfo.setImage(**target.sceneImage)
+            .setViewType(vk::ImageViewType::e2D)
+            .setFormat(target.swapchainFormat)
+            .setSubresourceRange({ vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1 });
+        target.sceneImageView.emplace(*engine.resorces.device, viewInfo);
+
+        target.sceneCapacity = required;
+        fmt::println("Scene target for window {}: {}x{}", target.windowIndex, required.width, required.height);
+    }
 
     void createGraphicsPipeline() {
+        KITSUNE_TRACE_FUNCTION();
         auto vertCode = loadShader("shaders/shader.vert.spv");
         auto fragCode = loadShader("shaders/shader.frag.spv");
         vk::raii::ShaderModule vertModule(*engine.resorces.device, vk::ShaderModuleCreateInfo{ {}, vertCode.size(), reinterpret_cast<const uint32_t*>(vertCode.data()) });
@@ -218,7 +423,7 @@ private:
         vkPipelineLayout.emplace(*engine.resorces.device, vk::PipelineLayoutCreateInfo{});
 
         vk::PipelineRenderingCreateInfo renderingInfo{};
-        renderingInfo.setColorAttachmentCount(1).setPColorAttachmentFormats(&swapchainFormat);
+        renderingInfo.setColorAttachmentCount(1).setPColorAttachmentFormats(&targets.front().swapchainFormat);
 
         vk::GraphicsPipelineCreateInfo pipelineInfo{};
         pipelineInfo.setStageCount(static_cast<uint32_t>(stages.size()))
@@ -238,21 +443,28 @@ private:
 
 
     void createSynchronizationObjects() {
+        KITSUNE_TRACE_FUNCTION();
         vk::SemaphoreCreateInfo semaphoreInfo{};
         vk::FenceCreateInfo fenceInfo{ vk::FenceCreateFlagBits::eSignaled };
 
-        imageAvailableSemaphores.reserve(MAX_FRAMES_IN_FLIGHT);
         renderFinishedSemaphores.reserve(MAX_FRAMES_IN_FLIGHT);
         inFlightFences.reserve(MAX_FRAMES_IN_FLIGHT);
 
         for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
-            imageAvailableSemaphores.emplace_back(*engine.resorces.device, semaphoreInfo);
             renderFinishedSemaphores.emplace_back(*engine.resorces.device, semaphoreInfo);
             inFlightFences.emplace_back(*engine.resorces.device, fenceInfo);
         }
+
+        for (auto& target : targets) {
+            target.imageAvailableSemaphores.reserve(MAX_FRAMES_IN_FLIGHT);
+            for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
+                target.imageAvailableSemaphores.emplace_back(*engine.resorces.device, semaphoreInfo);
+            }
+        }
     }
 
     void createCommandBuffers() {
+        KITSUNE_TRACE_FUNCTION();
         vk::CommandBufferAllocateInfo allocInfo{};
         allocInfo.setCommandPool(*vkCommandPool)
             .setLevel(vk::CommandBufferLevel::ePrimary)
@@ -261,19 +473,56 @@ private:
     }
 
     // Rendering Methods
-    void renderFrame() {
-        auto waitResult = engine.resorces.device->waitForFences(*inFlightFences[currentFrame], VK_TRUE, UINT64_MAX);
 
-        auto [result, imageIndex] = vkSwapchain->acquireNextImage(UINT64_MAX, *imageAvailableSemaphores[currentFrame], nullptr);
-        currentImage = imageIndex;
+    bool shouldRenderFrame() const {
+        bool canRender = std::any_of(targets.begin(), targets.end(), [](const WindowTarget& target) { return target.CanRender(); });
+        // A pending capture only keeps on-demand rendering awake while the primary window can be captured;
+        // otherwise the capture waits until that window is visible again.
+        bool wantsCapture = readback.HasPendingCaptures() && canCapturePrimary();
+        return canRender && (renderMode == RenderMode::Continuous || isDirty || wantsCapture);
+    }
+
+    bool canCapturePrimary() const {
+        return !targets.empty() && targets[0].canCaptureSwapchain && targets[0].CanRender();
+    }
 
-        if (result == vk::Result::eErrorOutOfDateKHR) {
-            recreateSwapchain();
-            return;
+    // Call once the in-flight fence of `frameSlot` has signaled. Safe to call more than once.
+    void onFrameSlotCompleted(uint32_t frameSlot) {
+        engine.CollectRetired(slotFrameNumbers[frameSlot]);
+        readback.OnFrameCompleted(frameSlot);
+        if (gpuTimer.CollectFrame(frameSlot)) {
+            dynamicResolution.Update(gpuTimer.GetLastFrameTimeMs());
         }
-        else if (result != vk::Result::eSuccess && result != vk::Result::eSuboptimalKHR) {
-            throw std::runtime_error("Failed to acquire swapchain image");
+    }
+
+    void completeFramesInFlight() {
+        if (!hasFramesInFlight) return;
+        KITSUNE_TRACE_FUNCTION();
+        // Frames complete in submission order, so walk the slots oldest first.
+        for (uint32_t i = 1; i <= MAX_FRAMES_IN_FLIGHT; ++i) {
+            uint32_t frameSlot = (currentFrame + i) % MAX_FRAMES_IN_FLIGHT;
+            auto waitResult = engine.resorces.device->waitForFences(*inFlightFences[frameSlot], VK_TRUE, UINT64_MAX);
+            onFrameSlotCompleted(frameSlot);
+        }
+        hasFramesInFlight = false;
+    }
+
+    // Records every window into one command buffer, submits it once and presents all
+    // acquired swapchains with a single presentKHR.
+    void renderFrame() {
+        KITSUNE_TRACE_FUNCTION();
+        {
+            KITSUNE_TRACE_ZONE("waitForFences");
+            auto waitResult = engine.resorces.device->waitForFences(*inFlightFences[currentFrame], VK_TRUE, UINT64_MAX);
         }
+        onFrameSlotCompleted(currentFrame);
+
+        if (!acquireImages()) return;
+        isDirty = false;
+        hasFramesInFlight = true;
+
+        frameNumber = engine.BeginFrame();
+        slotFrameNumbers[currentFrame] = frameNumber;
 
         engine.resorces.device->resetFences(*inFlightFences[currentFrame]);
         vk::raii::CommandBuffer& cmd = commandBuffers[currentFrame];
@@ -281,87 +530,262 @@ private:
 
         vk::CommandBufferBeginInfo beginInfo{ vk::CommandBufferUsageFlagBits::eOneTimeSubmit };
         cmd.begin(beginInfo);
+        gpuTimer.BeginFrame(cmd, currentFrame);
+        uint32_t frameZone = gpuTimer.BeginZone(cmd, "GPU Frame");
 
-        transitionImageLayout(cmd, imageIndex,
-            vk::ImageLayout::eUndefined, vk::ImageLayout::eColorAttachmentOptimal,
-            vk::AccessFlagBits2::eNone, vk::AccessFlagBits2::eColorAttachmentWrite,
-            vk::PipelineStageFlagBits2::eTopOfPipe, vk::PipelineStageFlagBits2::eColorAttachmentOutput);
-
-        vk::RenderingInfo renderingInfo = getRenderingInfo(imageIndex);
-        cmd.beginRendering(renderingInfo);
-
-        cmd.bindPipeline(vk::PipelineBindPoint::eGraphics, *vkGraphicsPipeline);
-        cmd.setViewport(0, vk::Viewport{ 0.0f, 0.0f, static_cast<float>(swapchainExtent.width), static_cast<float>(swapchainExtent.height), 0.0f, 1.0f });
-        cmd.setScissor(0, vk::Rect2D{ {0, 0}, swapchainExtent });
-        cmd.setCullMode(vk::CullModeFlagBits::eNone);
-        cmd.setFrontFace(vk::FrontFace::eCounterClockwise);
-        cmd.setPrimitiveTopology(vk::PrimitiveTopology::eTriangleList);
-        cmd.draw(3, 1, 0, 0);
-        cmd.endRendering();
-
-        transitionImageLayout(cmd, imageIndex,
-            vk::ImageLayout::eColorAttachmentOptimal, vk::ImageLayout::ePresentSrcKHR,
-            vk::AccessFlagBits2::eColorAttachmentWrite, vk::AccessFlagBits2::eNone,
-            vk::PipelineStageFlagBits2::eColorAttachmentOutput, vk::PipelineStageFlagBits2::eBottomOfPipe);
+        for (auto& target : targets) {
+            if (target.isAcquired) {
+                recordTarget(cmd, target);
+            }
+        }
 
+        gpuTimer.EndZone(cmd, frameZone);
         cmd.end();
 
+        std::vector<vk::Semaphore> waitSemaphores;
+        std::vector<vk::PipelineStageFlags> waitStages;
+        for (const auto& target : targets) {
+            if (target.isAcquired) {
+                waitSemaphores.push_back(*target.imageAvailableSemaphores[currentFrame]);
+                waitStages.push_back(vk::PipelineStageFlagBits::eTopOfPipe);
+            }
+        }
+
         vk::SubmitInfo submitInfo{};
-        vk::PipelineStageFlags waitStage{ vk::PipelineStageFlagBits::eTopOfPipe }; // Fixed from TopOfPipe
-        submitInfo.setWaitSemaphoreCount(1)
-            .setPWaitSemaphores(&(*imageAvailableSemaphores[currentFrame]))
-            .setPWaitDstStageMask(&waitStage)
+        submitInfo.setWaitSemaphoreCount(static_cast<uint32_t>(waitSemaphores.size()))
+            .setPWaitSemaphores(waitSemaphores.data())
+            .setPWaitDstStageMask(waitStages.data())
             .setCommandBufferCount(1)
             .setPCommandBuffers(&(*cmd))
             .setSignalSemaphoreCount(1)
             .setPSignalSemaphores(&(*renderFinishedSemaphores[currentFrame]));
 
-        engine.resorces.graphicsQueue->submit(submitInfo, *inFlightFences[currentFrame]);
-
-        vk::Result presentResult = presentImage(imageIndex);
-        if (presentResult == vk::Result::eErrorOutOfDateKHR || presentResult == vk::Result::eSuboptimalKHR) {
-            recreateSwapchain();
+        {
+            KITSUNE_TRACE_ZONE("submit");
+            engine.resorces.graphicsQueue->submit(submitInfo, *inFlightFences[currentFrame]);
         }
-        else if (presentResult != vk::Result::eSuccess) {
-            throw std::runtime_error("Failed to present swapchain image");
+
+        {
+            KITSUNE_TRACE_ZONE("presentKHR");
+            presentImages();
         }
 
         currentFrame = (currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
     }
 
+    // Returns false when no window has an image to render into this frame.
+    bool acquireImages() {
+        KITSUNE_TRACE_ZONE("acquireNextImage");
+        bool anyAcquired = false;
+        for (auto& target : targets) {
+            target.isAcquired = false;
+            if (!target.CanRender()) continue;
+
+            auto [result, imageIndex] = target.vkSwapchain->acquireNextImage(UINT64_MAX, *target.imageAvailableSemaphores[currentFrame], nullptr);
+            if (result == vk::Result::eErrorOutOfDateKHR) {
+                recreateSwapchain(target);
+                continue;
+            }
+            else if (result != vk::Result::eSuccess && result != vk::Result::eSuboptimalKHR) {
+                throw std::runtime_error("Failed to acquire swapchain image");
+            }
+
+            target.currentImage = imageIndex;
+            target.isAcquired = true;
+            anyAcquired = true;
+        }
+        return anyAcquired;
+    }
+
+    // Every window draws the same scene. Rebuild only when the scene or a pipeline changes:
+    // the queue persists across frames and cached scene passes are re-recorded from it.
+    void buildRenderQueue() {
+        KITSUNE_TRACE_FUNCTION();
+        renderQueue.Clear();
+
+        DrawPacket triangle{};
+        triangle.key = RenderKey::Make(0, 0, 0);
+        triangle.pipeline = **vkGraphicsPipeline;
+        triangle.layout = **vkPipelineLayout;
+        triangle.cullMode = vk::CullModeFlagBits::eNone;
+        triangle.frontFace = vk::FrontFace::eCounterClockwise;
+        triangle.topology = vk::PrimitiveTopology::eTriangleList;
+        triangle.count = 3;
+        renderQueue.Submit(triangle);
+
+        renderQueue.Sort();
+        MarkDirty();
+    }
+
+    void recordScenePass(const vk::raii::CommandBuffer& cmd, vk::Extent2D renderExtent) {
+        renderQueue.Record(cmd,
+            vk::Viewport{ 0.0f, 0.0f, static_cast<float>(renderExtent.width), static_cast<float>(renderExtent.height), 0.0f, 1.0f },
+            vk::Rect2D{ {0, 0}, renderExtent });
+    }
+
+    void recordTarget(const vk::raii::CommandBuffer& cmd, WindowTarget& target) {
+        vk::Image image = target.swapchainImages[target.currentImage];
+
+        // Without a scene target the scene goes straight into the swapchain image at full size.
+        const bool useSceneTarget = target.sceneImage.has_value();
+        target.renderExtent = useSceneTarget
+            ? dynamicResolution.GetRenderExtent(target.swapchainExtent, target.sceneCapacity)
+            : target.swapchainExtent;
+        vk::Image renderImage = useSceneTarget ? **target.sceneImage : image;
+        vk::ImageView renderView = useSceneTarget ? **target.sceneImageView : *target.swapchainImageViews[target.currentImage];
+
+        // The scene target is shared by every frame in flight, so the previous frame's upscale blit
+        // may still be reading it; wait for that read before the layout transition overwrites it.
+        transitionImageLayout(cmd, renderImage,
+            vk::ImageLayout::eUndefined, vk::ImageLayout::eColorAttachmentOptimal,
+            vk::AccessFlagBits2::eNone, vk::AccessFlagBits2::eColorAttachmentWrite,
+            useSceneTarget ? vk::PipelineStageFlagBits2::eBlit : vk::PipelineStageFlagBits2::eTopOfPipe,
+            vk::PipelineStageFlagBits2::eColorAttachmentOutput);
+
+        uint32_t sceneZone = gpuTimer.BeginZone(cmd, "Scene", vk::PipelineStageFlagBits2::eColorAttachmentOutput);
+        vk::RenderingAttachmentInfo colorAttachment = getColorAttachment(renderView);
+        vk::RenderingInfo renderingInfo = getRenderingInfo(colorAttachment, target.renderExtent);
+        if (useCommandCache) {
+            // The scene pass is replayed until the queue, the swapchain or the render extent changes.
+            CommandCacheKey key{ renderQueue.GetGeneration(), target.swapchainVersion, target.swapchainFormat, target.renderExtent };
+            const vk::raii::CommandBuffer& scenePass = commandCache.GetOrRecord(target.windowIndex, currentFrame, key,
+                [&](const vk::raii::CommandBuffer& secondary) { recordScenePass(secondary, target.renderExtent); });
+            renderingInfo.setFlags(vk::RenderingFlagBits::eContentsSecondaryCommandBuffers);
+            cmd.beginRendering(renderingInfo);
+            cmd.executeCommands(*scenePass);
+        }
+        else {
+            cmd.beginRendering(renderingInfo);
+            recordScenePass(cmd, target.renderExtent);
+        }
+        cmd.endRendering();
+        gpuTimer.EndZone(cmd, sceneZone, vk::PipelineStageFlagBits2::eColorAttachmentOutput);
+
+        ImageState swapchainState{ vk::ImageLayout::eColorAttachmentOptimal, vk::AccessFlagBits2::eColorAttachmentWrite,
+                                   vk::PipelineStageFlagBits2::eColorAttachmentOutput };
+        if (useSceneTarget) {
+            swapchainState = recordUpscale(cmd, target);
+        }
+
+        // Captures always come from the primary window.
+        if (target.windowIndex == 0 && target.canCaptureSwapchain && readback.WantsCapture(frameNumber)) {
+            recordCapture(cmd, target, swapchainState);
+        }
+        else {
+            transitionImageLayout(cmd, image,
+                swapchainState.layout, vk::ImageLayout::ePresentSrcKHR,
+                swapchainState.access, vk::AccessFlagBits2::eNone,
+                swapchainState.stage, vk::PipelineStageFlagBits2::eBottomOfPipe);
+        }
+    }
+
+    // Blits the rendered sub-region of the scene target over the whole swapchain image.
+    ImageState recordUpscale(const vk::raii::CommandBuffer& cmd, const WindowTarget& target) {
+        vk::Image image = target.swapchainImages[target.currentImage];
+        uint32_t upscaleZone = gpuTimer.BeginZone(cmd, "Upscale", vk::PipelineStageFlagBits2::eBlit);
+
+        transitionImageLayout(cmd, **target.sceneImage,
+            vk::ImageLayout::eColorAttachmentOptimal, vk::ImageLayout::eTransferSrcOptimal,
+            vk::AccessFlagBits2::eColorAttachmentWrite, vk::AccessFlagBits2::eTransferRead,
+            vk::PipelineStageFlagBits2::eColorAttachmentOutput, vk::PipelineStageFlagBits2::eBlit);
+        transitionImageLayout(cmd, image,
+            vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal,
+            vk::AccessFlagBits2::eNone, vk::AccessFlagBits2::eTransferWrite,
+            vk::PipelineStageFlagBits2::eTopOfPipe, vk::PipelineStageFlagBits2::eBlit);
+
+        vk::ImageBlit region{};
+        region.setSrcSubresource({ vk::ImageAspectFlagBits::eColor, 0, 0, 1 })
+            .setSrcOffsets({ vk::Offset3D{ 0, 0, 0 },
+                vk::Offset3D{ static_cast<int32_t>(target.renderExtent.width), static_cast<int32_t>(target.renderExtent.height), 1 } })
+            .setDstSubresource({ vk::ImageAspectFlagBits::eColor, 0, 0, 1 })
+            .setDstOffsets({ vk::Offset3D{ 0, 0, 0 },
+                vk::Offset3D{ static_cast<int32_t>(target.swapchainExtent.width), static_cast<int32_t>(target.swapchainExtent.height), 1 } });
+        cmd.blitImage(**target.sceneImage, vk::ImageLayout::eTransferSrcOptimal,
+            image, vk::ImageLayout::eTransferDstOptimal, region, upscaleFilter);
+
+        gpuTimer.EndZone(cmd, upscaleZone, vk::PipelineStageFlagBits2::eBlit);
+        return { vk::ImageLayout::eTransferDstOptimal, vk::AccessFlagBits2::eTransferWrite, vk::PipelineStageFlagBits2::eBlit };
+    }
+
+    void recordCapture(const vk::raii::CommandBuffer& cmd, const WindowTarget& target, const ImageState& state) {
+        vk::Image image = target.swapchainImages[target.currentImage];
+
+        transitionImageLayout(cmd, image,
+            state.layout, vk::ImageLayout::eTransferSrcOptimal,
+            state.access, vk::AccessFlagBits2::eTransferRead,
+            state.stage, vk::PipelineStageFlagBits2::eCopy);
+
+        readback.RecordCopy(cmd, image, target.swapchainExtent, target.swapchainFormat, currentFrame, frameNumber);
+
+        transitionImageLayout(cmd, image,
+            vk::ImageLayout::eTransferSrcOptimal, vk::ImageLayout::ePresentSrcKHR,
+            vk::AccessFlagBits2::eTransferRead, vk::AccessFlagBits2::eNone,
+            vk::PipelineStageFlagBits2::eCopy, vk::PipelineStageFlagBits2::eBottomOfPipe);
+    }
+
 
-    vk::RenderingInfo getRenderingInfo(uint32_t imageIndex) const {
+    vk::RenderingAttachmentInfo getColorAttachment(vk::ImageView imageView) const {
         vk::RenderingAttachmentInfo colorAttachment{};
-        colorAttachment.setImageView(*swapchainImageViews[imageIndex])
+        colorAttachment.setImageView(imageView)
             .setImageLayout(vk::ImageLayout::eColorAttachmentOptimal)
             .setLoadOp(vk::AttachmentLoadOp::eClear)
             .setStoreOp(vk::AttachmentStoreOp::eStore)
             .setClearValue({ std::array<float, 4>{0.2f, 0.2f, 0.2f, 1.0f} });
+        return colorAttachment;
+    }
 
+    vk::RenderingInfo getRenderingInfo(const vk::RenderingAttachmentInfo& colorAttachment, vk::Extent2D extent) const {
         vk::RenderingInfo renderingInfo{};
-        renderingInfo.setRenderArea({ {0, 0}, swapchainExtent })
+        renderingInfo.setRenderArea({ {0, 0}, extent })
             .setLayerCount(1)
             .setColorAttachmentCount(1)
             .setPColorAttachments(&colorAttachment);
         return renderingInfo;
     }
 
-    vk::Result presentImage(uint32_t imageIndex) {
+    void presentImages() {
+        std::vector<vk::SwapchainKHR> swapchains;
+        std::vector<uint32_t> imageIndices;
+        std::vector<WindowTarget*> presented;
+        for (auto& target : targets) {
+            if (target.isAcquired) {
+                swapchains.push_back(**target.vkSwapchain);
+                imageIndices.push_back(target.currentImage);
+                presented.push_back(&target);
+            }
+        }
+        std::vector<vk::Result> results(swapchains.size(), vk::Result::eSuccess);
+
         vk::PresentInfoKHR presentInfo{};
         presentInfo.setWaitSemaphoreCount(1)
             .setPWaitSemaphores(&(*renderFinishedSemaphores[currentFrame]))
-            .setSwapchainCount(1)
-            .setPSwapchains(&(**vkSwapchain))
-            .setPImageIndices(&imageIndex);
-        return engine.resorces.presentQueue->presentKHR(presentInfo);
+            .setSwapchainCount(static_cast<uint32_t>(swapchains.size()))
+            .setPSwapchains(swapchains.data())
+            .setPImageIndices(imageIndices.data())
+            .setPResults(results.data());
+        try {
+            engine.resorces.presentQueue->presentKHR(presentInfo);
+        }
+        catch (const vk::OutOfDateKHRError&) {
+            // Per-swapchain results below still tell which windows need a new swapchain.
+        }
+
+        for (size_t i = 0; i < presented.size(); ++i) {
+            if (results[i] == vk::Result::eErrorOutOfDateKHR || results[i] == vk::Result::eSuboptimalKHR) {
+                recreateSwapchain(*presented[i]);
+            }
+            else if (results[i] != vk::Result::eSuccess) {
+                throw std::runtime_error("Failed to present swapchain image");
+            }
+        }
     }
 
-    void transitionImageLayout(const vk::raii::CommandBuffer& cmd, uint32_t imageIndex,
+    void transitionImageLayout(const vk::raii::CommandBuffer& cmd, vk::Image image,
         vk::ImageLayout oldLayout, vk::ImageLayout newLayout,
         vk::AccessFlags2 srcAccess, vk::AccessFlags2 dstAccess,
         vk::PipelineStageFlags2 srcStage, vk::PipelineStageFlags2 dstStage) const {
         vk::ImageMemoryBarrier2 barrier{};
-        barrier.setImage(swapchainImages[imageIndex])
+        barrier.setImage(image)
             .setOldLayout(oldLayout)
             .setNewLayout(newLayout)
             .setSrcStageMask(srcStage)
@@ -380,38 +804,112 @@ private:
 
 
 
-    void recreateSwapchain() {
-        engine.WaitForIdle();
-        windowExtent = windowing.GetWindowExtent();
-        if (windowExtent.width == 0 || windowExtent.height == 0) return;
+    void recreateSwapchain(WindowTarget& target) {
+        KITSUNE_TRACE_FUNCTION();
+        target.windowExtent = windowing.GetWindowExtent(target.windowIndex);
+        if (target.windowExtent.width == 0 || target.windowExtent.height == 0) return;
 
-        swapchainImageViews.clear();
-        vkSwapchain.reset();
+        // Frames in flight may still reference the old views and swapchain; the engine
+        // releases them once those frames complete instead of stalling the device.
+        engine.Retire(std::exchange(target.swapchainImageViews, {}));
+        vk::raii::SwapchainKHR oldSwapchain = std::move(*target.vkSwapchain);
+        target.vkSwapchain.reset();
 
-        createSwapchain();
-        createImageViews();
+        createSwapchain(target, *oldSwapchain);
+        engine.Retire(std::move(oldSwapchain));
+        createImageViews(target);
+        createSceneTarget(target);
         isFramebufferResized = false;
     }
 
+    WindowTarget* findTarget(SDL_WindowID windowId) {
+        std::optional<uint32_t> index = windowing.GetWindowIndex(windowId);
+        return index ? &targets[*index] : nullptr;
+    }
+
     // Event Handling
-    void processEvents() {
+    // With `waitForEvents` the loop sleeps until the first event arrives or the idle timeout expires.
+    void processEvents(bool waitForEvents) {
+        KITSUNE_TRACE_FUNCTION();
         SDL_Event event;
-        while (SDL_PollEvent(&event)) {
+        bool hasEvent = waitForEvents ? SDL_WaitEventTimeout(&event, IDLE_WAIT_TIMEOUT_MS) : SDL_PollEvent(&event);
+        for (; hasEvent; hasEvent = SDL_PollEvent(&event)) {
             switch (event.type) {
             case SDL_EVENT_QUIT:
                 isRunning = false;
                 break;
+            case SDL_EVENT_WINDOW_CLOSE_REQUESTED:
+                // Closing a secondary viewport only hides it; closing the primary window quits.
+                if (WindowTarget* target = findTarget(event.window.windowID)) {
+                    if (target->windowIndex == 0) {
+                        isRunning = false;
+                    }
+                    else {
+                        target->isRenderingEnabled = false;
+                        windowing.HideWindow(target->windowIndex);
+                    }
+                }
+                break;
             case SDL_EVENT_WINDOW_PIXEL_SIZE_CHANGED:
-                windowExtent = windowing.GetWindowExtent();
-                fmt::println("Window resized: {}x{}", windowExtent.width, windowExtent.height);
-                isFramebufferResized = true;
-                recreateSwapchain();
+                if (WindowTarget* target = findTarget(event.window.windowID)) {
+                    target->windowExtent = windowing.GetWindowExtent(target->windowIndex);
+                    fmt::println("Window {} resized: {}x{}", target->windowIndex, target->windowExtent.width, target->windowExtent.height);
+                    isFramebufferResized = true;
+                    recreateSwapchain(*target);
+                    MarkDirty();
+                }
                 break;
             case SDL_EVENT_WINDOW_MINIMIZED:
-                isRenderingEnabled = false;
+                if (WindowTarget* target = findTarget(event.window.windowID)) {
+                    target->isRenderingEnabled = false;
+                }
                 break;
             case SDL_EVENT_WINDOW_RESTORED:
-                isRenderingEnabled = true;
+                if (WindowTarget* target = findTarget(event.window.windowID)) {
+                    target->isRenderingEnabled = true;
+                    MarkDirty();
+                }
+                break;
+            case SDL_EVENT_WINDOW_HIDDEN:
+            case SDL_EVENT_WINDOW_OCCLUDED:
+                if (WindowTarget* target = findTarget(event.window.windowID)) {
+                    target->isOccluded = true;
+                }
+                break;
+            case SDL_EVENT_WINDOW_SHOWN:
+            case SDL_EVENT_WINDOW_EXPOSED:
+                if (WindowTarget* target = findTarget(event.window.windowID)) {
+                    target->isOccluded = false;
+                    MarkDirty();
+                }
+                break;
+            case SDL_EVENT_KEY_DOWN:
+                if (event.key.key == SDLK_F12 && !event.key.repeat) {
+                    // Shift+F12 captures the next 600 frames for benchmark runs, F12 a single frame.
+                    if (targets.empty() || !targets[0].canCaptureSwapchain) {
+                        fmt::println("Capture unavailable: the swapchain does not support readback");
+                    }
+                    else if (event.key.mod & SDL_KMOD_SHIFT) readback.RequestCapture(600);
+                    else readback.RequestCapture();
+                }
+                if (event.key.key == SDLK_F6 && !event.key.repeat) {
+                    useCommandCache = !useCommandCache;
+                    const CommandCacheStats& cacheStats = commandCache.GetStats();
+                    fmt::println("Cached scene passes: {} ({} recorded, {} reused)", useCommandCache ? "on" : "off",
+                        cacheStats.recorded, cacheStats.reused);
+                }
+                if (event.key.key == SDLK_F7 && !event.key.repeat) {
+                    SetRenderMode(renderMode == RenderMode::Continuous ? RenderMode::OnDemand : RenderMode::Continuous);
+                    fmt::println("Render mode: {}", renderMode == RenderMode::Continuous ? "continuous" : "on demand");
+                }
+                if (event.key.key == SDLK_F8 && !event.key.repeat) {
+                    engine.GetMemory().LogStats();
+                }
+#if defined(KITSUNE_ENABLE_TRACE)
+                if (event.key.key == SDLK_F9 && !event.key.repeat) {
+                    KitsuneTrace::ExportChromeTrace(fmt::format("{}traces/trace_{:06}.json", basePath, frameNumber));
+                }
+#endif
                 break;
             }
         }
@@ -419,18 +917,6 @@ private:
 
     // Utility Methods
 
-
-    QueueFamilyIndices findQueueFamilies(const vk::raii::PhysicalDevice& device) {
-        QueueFamilyIndices indices;
-        auto families = device.getQueueFamilyProperties();
-        for (uint32_t i = 0; i < families.size(); ++i) {
-            if (families[i].queueFlags & vk::QueueFlagBits::eGraphics) indices.graphics = i;
-            if (device.getSurfaceSupportKHR(i, *engine.resorces.surface)) indices.present = i;
-            if (indices.graphics && indices.present) break;
-        }
-        return indices;
-    }
-
     vk::SurfaceFormatKHR chooseSwapchainFormat(const std::vector<vk::SurfaceFormatKHR>& formats) const {
         for (const auto& format : formats) {
             if (format.format == vk::Format::eB8G8R8A8Srgb && format.colorSpace == vk::ColorSpaceKHR::eSrgbNonlinear) {
@@ -444,11 +930,11 @@ private:
         return useVsync ? vk::PresentModeKHR::eFifo : vk::PresentModeKHR::eImmediate;
     }
 
-    vk::Extent2D chooseSwapchainExtent(const vk::SurfaceCapabilitiesKHR& caps) const {
+    vk::Extent2D chooseSwapchainExtent(const vk::SurfaceCapabilitiesKHR& caps, uint32_t windowIndex) const {
         if (caps.currentExtent.width != std::numeric_limits<uint32_t>::max()) {
             return caps.currentExtent;
         }
-        vk::Extent2D extent = windowing.GetWindowExtent();
+        vk::Extent2D extent = windowing.GetWindowExtent(windowIndex);
         extent.width = std::clamp(extent.width, caps.minImageExtent.width, caps.maxImageExtent.width);
         extent.height = std::clamp(extent.height, caps.minImageExtent.height, caps.maxImageExtent.height);
         return extent;
@@ -473,9 +959,23 @@ private:
     }
 };
 
-int main() {
+int main(int argc, char* argv[]) {
+    // --windows <count> opens additional viewports that share the device and the frame's submit/present.
+    // --on-demand only renders when a window changes instead of every loop iteration.
+    uint32_t windowCount = 1;
+    RenderMode renderMode = RenderMode::Continuous;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (arg == "--windows" && i + 1 < argc) {
+            windowCount = static_cast<uint32_t>(std::max(1, std::atoi(argv[++i])));
+        }
+        else if (arg == "--on-demand") {
+            renderMode = RenderMode::OnDemand;
+        }
+    }
+
     try {
-        HelloTriangle app;
+        HelloTriangle app{ windowCount, renderMode };
         app.initialize();
         app.run();
     }
@@ -485,4 +985,3 @@ int main() {
     }
     return 0;
 }
-
@@ -0,0 +1,75 @@
+#include <kitsune_command_cache.hpp>
+#include <kitsune_trace.hpp>
+
+KitsuneCommandCache::KitsuneCommandCache(KitsuneEngine& engine) : engine_(engine) {}
+KitsuneCommandCache::~KitsuneCommandCache() {}
+
+void KitsuneCommandCache::Init(uint32_t entryCount)
+{
+    KITSUNE_TRACE_FUNCTION();
+    vk::CommandPoolCreateInfo poolInfo{};
+    poolInfo.setQueueFamilyIndex(*engine_.GetQueueFamilyIndices().graphics)
+        .setFlags(vk::CommandPoolCreateFlagBits::eResetCommandBuffer);
+    commandPool.emplace(*engine_.resorces.device, poolInfo);
+    entries.resize(entryCount);
+}
+
+const vk::raii::CommandBuffer& KitsuneCommandCache::GetOrRecord(uint32_t entry, uint32_t frameSlot, const CommandCacheKey& key,
+    const RecordFunction& record)
+{
+    CachedBuffer& cached = entries.at(entry)[frameSlot];
+    if (cached.buffer && cached.key == key) {
+        ++stats.reused;
+        return *cached.buffer;
+    }
+
+    KITSUNE_TRACE_ZONE("CommandCache::Record");
+    if (!cached.buffer) {
+        vk::CommandBufferAllocateInfo allocInfo{};
+        allocInfo.setCommandPool(**commandPool)
+            .setLevel(vk::CommandBufferLevel::eSecondary)
+            .setCommandBufferCount(1);
+        cached.buffer.emplace(std::move(engine_.resorces.device->allocateCommandBuffers(allocInfo).front()));
+    }
+    else {
+        cached.buffer->reset();
+    }
+
+    vk::CommandBufferInheritanceRenderingInfo renderingInheritance{};
+    renderingInheritance.setColorAttachmentCount(1)
+        .setPColorAttachmentFormats(&key.colorFormat)
+        .setRasterizationSamples(vk::SampleCountFlagBits::e1);
+
+    vk::CommandBufferInheritanceInfo inheritance{};
+    inheritance.setPNext(&renderingInheritance);
+
+    // No eOneTimeSubmit: the buffer is replayed until its key changes.
+    vk::CommandBufferBeginInfo beginInfo{};
+    beginInfo.setFlags(vk::CommandBufferUsageFlagBits::eRenderPassContinue)
+        .setPInheritanceInfo(&inheritance);
+
+    // Drop the key first so a throwing record leaves the buffer marked stale.
+    cached.key.reset();
+    cached.buffer->begin(beginInfo);
+    record(*cached.buffer);
+    cached.buffer->end();
+    cached.key = key;
+
+    ++stats.recorded;
+    return *cached.buffer;
+}
+
+void KitsuneCommandCache::Invalidate(uint32_t entry)
+{
+    if (entry >= entries.size()) return;
+    for (auto& cached : entries[entry]) {
+        cached.key.reset();
+    }
+}
+
+void KitsuneCommandCache::InvalidateAll()
+{
+    for (uint32_t entry = 0; entry < entries.size(); ++entry) {
+        Invalidate(entry);
+    }
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include <kitsune_types.h>
+#include <kitsune_engine.hpp>
+
+// Everything a cached pass was recorded against. A cached command buffer is replayed as long
+// as the key matches and re-recorded the first time it does not.
+struct CommandCacheKey
+{
+	// Bump when what the pass draws changes: scene edits, pipeline swaps.
+	uint64_t contentVersion{ 0 };
+	// Bump when the render target is recreated, e.g. on swapchain recreation.
+	uint64_t targetVersion{ 0 };
+	vk::Format colorFormat{ vk::Format::eUndefined };
+	vk::Extent2D extent{ 0, 0 };
+
+	bool operator==(const CommandCacheKey& other) const
+	{
+		return contentVersion == other.contentVersion && targetVersion == other.targetVersion &&
+			colorFormat == other.colorFormat && extent == other.extent;
+	}
+	bool operator!=(const CommandCacheKey& other) const { return !(*this == other); }
+};
+
+struct CommandCacheStats
+{
+	uint64_t recorded{ 0 };
+	uint64_t reused{ 0 };
+};
+
+// Secondary command buffers for static passes, executed inside a dynamic rendering scope
+// begun with vk::RenderingFlagBits::eContentsSecondaryCommandBuffers. Each entry keeps one
+// buffer per frame in flight, and a buffer is only re-recorded from GetOrRecord() after its
+// frame slot's fence has signaled, so no buffer is ever rewritten while the GPU may use it.
+class KitsuneCommandCache
+{
+public:
+	using RecordFunction = std::function<void(const vk::raii::CommandBuffer& cmd)>;
+
+	explicit KitsuneCommandCache(KitsuneEngine& engine);
+	~KitsuneCommandCache();
+
+	// One entry per independently cached pass, e.g. per window.
+	void Init(uint32_t entryCount);
+
+	// Returns the buffer cached for `entry` in `frameSlot`, recording it with `record` first
+	// if it was never recorded or was recorded with a different key.
+	const vk::raii::CommandBuffer& GetOrRecord(uint32_t entry, uint32_t frameSlot, const CommandCacheKey& key,
+		const RecordFunction& record);
+
+	void Invalidate(uint32_t entry);
+	void InvalidateAll();
+
+	const CommandCacheStats& GetStats() const { return stats; }
+
+private:
+	struct CachedBuffer
+	{
+		std::optional<vk::raii::CommandBuffer> buffer{};
+		std::optional<CommandCacheKey> key{};
+	};
+
+	using Entry = std::array<CachedBuffer, MAX_FRAMES_IN_FLIGHT>;
+
+	KitsuneEngine& engine_;
+	// Declared before the entries so every buffer is freed before its pool.
+	std::optional<vk::raii::CommandPool> commandPool{};
+	std::vector<Entry> entries;
+	CommandCacheStats stats{};
+};
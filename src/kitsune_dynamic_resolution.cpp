@@ -0,0 +1,84 @@
+#include <kitsune_dynamic_resolution.hpp>
+
+#include <cmath>
+
+KitsuneDynamicResolution::KitsuneDynamicResolution(DynamicResolutionSettings settings) : settings_(settings)
+{
+    Reset();
+}
+
+void KitsuneDynamicResolution::Reset()
+{
+    scale = settings_.maxScale;
+    smoothedFrameTimeMs = 0.0;
+    overBudgetFrames = 0;
+    underBudgetFrames = 0;
+    cooldown = 0;
+}
+
+void KitsuneDynamicResolution::SetEnabled(bool enabled)
+{
+    isEnabled = enabled;
+    Reset();
+}
+
+void KitsuneDynamicResolution::SetSettings(const DynamicResolutionSettings& settings)
+{
+    settings_ = settings;
+    Reset();
+}
+
+void KitsuneDynamicResolution::Update(double gpuFrameTimeMs)
+{
+    if (!isEnabled || gpuFrameTimeMs <= 0.0) return;
+
+    if (cooldown > 0) {
+        --cooldown;
+        return;
+    }
+
+    smoothedFrameTimeMs = smoothedFrameTimeMs > 0.0
+        ? smoothedFrameTimeMs + (gpuFrameTimeMs - smoothedFrameTimeMs) * settings_.smoothing
+        : gpuFrameTimeMs;
+
+    const double upper = settings_.targetFrameTimeMs * settings_.upperThreshold;
+    const double lower = settings_.targetFrameTimeMs * settings_.lowerThreshold;
+
+    float newScale = scale;
+    if (smoothedFrameTimeMs > upper) {
+        underBudgetFrames = 0;
+        if (++overBudgetFrames >= settings_.framesToDecrease) {
+            newScale = std::max(settings_.minScale, scale - settings_.decreaseStep);
+            overBudgetFrames = 0;
+        }
+    }
+    else if (smoothedFrameTimeMs < lower) {
+        overBudgetFrames = 0;
+        if (++underBudgetFrames >= settings_.framesToIncrease) {
+            newScale = std::min(settings_.maxScale, scale + settings_.increaseStep);
+            underBudgetFrames = 0;
+        }
+    }
+    else {
+        overBudgetFrames = 0;
+        underBudgetFrames = 0;
+    }
+
+    if (newScale != scale) {
+        scale = newScale;
+        // The smoothed time still reflects the old resolution; start over after the cooldown.
+        smoothedFrameTimeMs = 0.0;
+        cooldown = settings_.cooldownFrames;
+    }
+}
+
+vk::Extent2D KitsuneDynamicResolution::GetRenderExtent(vk::Extent2D outputExtent, vk::Extent2D capacity) const
+{
+    const float renderScale = isEnabled ? scale : 1.0f;
+    vk::Extent2D extent{
+        static_cast<uint32_t>(std::lround(outputExtent.width * renderScale)),
+        static_cast<uint32_t>(std::lround(outputExtent.height * renderScale)) };
+    extent.width = std::clamp(extent.width, 1u, std::max(capacity.width, 1u));
+    extent.height = std::clamp(extent.height, 1u, std::max(capacity.height, 1u));
+    return extent;
+}
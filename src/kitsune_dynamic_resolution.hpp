@@ -0,0 +1,50 @@
+#pragma once
+#include <kitsune_types.h>
+
+struct DynamicResolutionSettings
+{
+	double targetFrameTimeMs{ 1000.0 / 60.0 };
+	float minScale{ 0.5f };
+	float maxScale{ 1.0f };
+	// Dropping resolution reacts faster than raising it again.
+	float decreaseStep{ 0.1f };
+	float increaseStep{ 0.05f };
+	// Hysteresis band around the budget, as fractions of targetFrameTimeMs.
+	double upperThreshold{ 0.95 };
+	double lowerThreshold{ 0.75 };
+	uint32_t framesToDecrease{ 3 };
+	uint32_t framesToIncrease{ 30 };
+	// Timings lag by the frames in flight; ignore them for a while after each change.
+	uint32_t cooldownFrames{ MAX_FRAMES_IN_FLIGHT + 2 };
+	double smoothing{ 0.2 };
+};
+
+// Picks a render scale from measured GPU frame time. The scene is rendered into a
+// sub-region of a render target preallocated at full size, so scaling never reallocates.
+class KitsuneDynamicResolution
+{
+public:
+	explicit KitsuneDynamicResolution(DynamicResolutionSettings settings = {});
+
+	void Update(double gpuFrameTimeMs);
+	void Reset();
+
+	void SetEnabled(bool enabled);
+	bool IsEnabled() const { return isEnabled; }
+	void SetSettings(const DynamicResolutionSettings& settings);
+	const DynamicResolutionSettings& GetSettings() const { return settings_; }
+
+	float GetScale() const { return scale; }
+	double GetSmoothedFrameTimeMs() const { return smoothedFrameTimeMs; }
+	// Scaled size of `outputExtent`, never larger than `capacity`.
+	vk::Extent2D GetRenderExtent(vk::Extent2D outputExtent, vk::Extent2D capacity) const;
+
+private:
+	DynamicResolutionSettings settings_;
+	bool isEnabled{ true };
+	float scale{ 1.0f };
+	double smoothedFrameTimeMs{ 0.0 };
+	uint32_t overBudgetFrames{ 0 };
+	uint32_t underBudgetFrames{ 0 };
+	uint32_t cooldown{ 0 };
+};
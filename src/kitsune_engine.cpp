@@ -1,10 +1,13 @@
 #include <kitsune_engine.hpp>
+#include <kitsune_trace.hpp>
 
 KitsuneEngine::KitsuneEngine(KitsuneWindowing& windowing) : windowing_(windowing) {}
 KitsuneEngine::~KitsuneEngine() {}
 
 void KitsuneEngine::Init()
 {
+    KITSUNE_TRACE_ZONE("KitsuneEngine::Init");
+
     windowExtent = windowing_.GetWindowExtent();
 
     basePath = SDL_GetBasePath() ? SDL_GetBasePath() : "./";
@@ -12,7 +15,7 @@ void KitsuneEngine::Init()
 
     CreateContext();
     CreateInstance();
-    CreateSurface();
+    CreateSurfaces();
     SelectPhysicalDevice();
     CreateLogicalDevice();
 }
@@ -22,14 +25,29 @@ void KitsuneEngine::ResetWindowExtent()
     windowExtent = windowing_.GetWindowExtent();
 }
 
+uint64_t KitsuneEngine::BeginFrame()
+{
+    memory.UpdateBudget();
+    return ++frameCounter;
+}
+
+void KitsuneEngine::CollectRetired(uint64_t completedFrame)
+{
+    while (!retiredObjects.empty() && retiredObjects.front().frame <= completedFrame) {
+        retiredObjects.pop_front();
+    }
+}
+
 void KitsuneEngine::CreateContext()
 {
+    KITSUNE_TRACE_FUNCTION();
     auto vkGetInstanceProcAddr = windowing_.GetVkGetInstanceProcAddr();
     resorces.context.emplace(vkGetInstanceProcAddr);
 }
 
 void KitsuneEngine::CreateInstance()
 {
+    KITSUNE_TRACE_FUNCTION();
     std::vector<vk::ExtensionProperties> availableExtensions = resorces.context->enumerateInstanceExtensionProperties();
     std::vector<const char*> requiredExtensions = GetRequiredInstanceExtensions(availableExtensions);
 
@@ -62,15 +80,21 @@ void KitsuneEngine::CreateInstance()
     resorces.instance.emplace(*resorces.context, createInfo);
 }
 
-void KitsuneEngine::CreateSurface()
+void KitsuneEngine::CreateSurfaces()
 {
+    KITSUNE_TRACE_FUNCTION();
     const vk::raii::Instance& vkInstance = *resorces.instance;
-    VkSurfaceKHR rawSurface = windowing_.GetSurface(vkInstance);
-    resorces.surface.emplace(vkInstance, rawSurface);
+    resorces.surfaces.clear();
+    resorces.surfaces.reserve(windowing_.GetWindowCount());
+    for (uint32_t i = 0; i < windowing_.GetWindowCount(); ++i) {
+        VkSurfaceKHR rawSurface = windowing_.GetSurface(vkInstance, i);
+        resorces.surfaces.emplace_back(vkInstance, rawSurface);
+    }
 }
 
 void KitsuneEngine::SelectPhysicalDevice()
 {
+    KITSUNE_TRACE_FUNCTION();
     auto devices = resorces.instance->enumeratePhysicalDevices();
     for (const auto& device : devices) {
         queueFamilyIndices = FindQueueFamilies(device);
@@ -84,6 +108,7 @@ void KitsuneEngine::SelectPhysicalDevice()
 
 void KitsuneEngine::CreateLogicalDevice() 
 {
+    KITSUNE_TRACE_FUNCTION();
     std::vector<vk::ExtensionProperties> availableExtensions = resorces.physicalDevice->enumerateDeviceExtensionProperties();
     std::vector<const char*> requiredExtensions{ vk::KHRSwapchainExtensionName, vk::KHRSynchronization2ExtensionName };
 
@@ -98,6 +123,18 @@ void KitsuneEngine::CreateLogicalDevice()
         }
     }
 
+    hasCalibratedTimestamps = std::any_of(availableExtensions.begin(), availableExtensions.end(),
+        [](const auto& ext) { return strcmp(ext.extensionName, vk::EXTCalibratedTimestampsExtensionName) == 0; });
+    if (hasCalibratedTimestamps) {
+        requiredExtensions.push_back(vk::EXTCalibratedTimestampsExtensionName);
+    }
+
+    hasMemoryBudget = std::any_of(availableExtensions.begin(), availableExtensions.end(),
+        [](const auto& ext) { return strcmp(ext.extensionName, vk::EXTMemoryBudgetExtensionName) == 0; });
+    if (hasMemoryBudget) {
+        requiredExtensions.push_back(vk::EXTMemoryBudgetExtensionName);
+    }
+
     std::set<uint32_t> uniqueFamilies = { *queueFamilyIndices.graphics, *queueFamilyIndices.present };
     std::vector<vk::DeviceQueueCreateInfo> queueInfos;
     float priority = 1.0f;
@@ -130,6 +167,8 @@ void KitsuneEngine::CreateLogicalDevice()
     resorces.device.emplace(*resorces.physicalDevice, createInfo);
     resorces.graphicsQueue.emplace(*resorces.device, *queueFamilyIndices.graphics, 0);
     resorces.presentQueue.emplace(*resorces.device, *queueFamilyIndices.present, 0);
+
+    memory.Init(*resorces.physicalDevice, hasMemoryBudget);
 }
 
 // Utility Methods
@@ -170,12 +209,33 @@ bool KitsuneEngine::AreExtensionsSupported(const std::vector<const char*>& requi
     return true;
 }
 
+uint32_t KitsuneEngine::FindMemoryType(uint32_t typeFilter, vk::MemoryPropertyFlags properties) const {
+    vk::PhysicalDeviceMemoryProperties memoryProperties = resorces.physicalDevice->getMemoryProperties();
+    for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; ++i) {
+        if ((typeFilter & (1u << i)) && (memoryProperties.memoryTypes[i].propertyFlags & properties) == properties) {
+            return i;
+        }
+    }
+    throw std::runtime_error("Failed to find suitable memory type");
+}
+
+KitsuneAllocation KitsuneEngine::AllocateMemory(const vk::MemoryRequirements& requirements, vk::MemoryPropertyFlags properties, MemoryCategory category) {
+    return AllocateMemory(requirements.size, FindMemoryType(requirements.memoryTypeBits, properties), category);
+}
+
+KitsuneAllocation KitsuneEngine::AllocateMemory(vk::DeviceSize size, uint32_t memoryTypeIndex, MemoryCategory category) {
+    return memory.Allocate(*resorces.device, size, memoryTypeIndex, category);
+}
+
 QueueFamilyIndices KitsuneEngine::FindQueueFamilies(const vk::raii::PhysicalDevice& device) const {
     QueueFamilyIndices indices;
     auto families = device.getQueueFamilyProperties();
     for (uint32_t i = 0; i < families.size(); ++i) {
         if (families[i].queueFlags & vk::QueueFlagBits::eGraphics) indices.graphics = i;
-        if (device.getSurfaceSupportKHR(i, *resorces.surface)) indices.present = i;
+        // All swapchains are presented with a single presentKHR, so one family must serve every surface.
+        bool supportsAllSurfaces = std::all_of(resorces.surfaces.begin(), resorces.surfaces.end(),
+            [&](const vk::raii::SurfaceKHR& surface) { return device.getSurfaceSupportKHR(i, *surface); });
+        if (supportsAllSurfaces) indices.present = i;
         if (indices.graphics && indices.present) break;
     }
     return indices;
@@ -1,6 +1,7 @@
 #pragma once
 #include <kitsune_types.h>
 #include <kitsune_windowing.hpp>
+#include <kitsune_memory.hpp>
 
 
 struct PerFrame
@@ -19,7 +20,8 @@ struct VulkanResorces
 	std::optional <vk::raii::Instance> instance{};
 	std::optional <vk::raii::PhysicalDevice> physicalDevice{};
 	std::optional <vk::raii::Device> device{};
-	std::optional <vk::raii::SurfaceKHR> surface{};
+	// One surface per KitsuneWindowing window, in window order.
+	std::vector<vk::raii::SurfaceKHR> surfaces{};
 	std::optional <vk::raii::SwapchainKHR> swapchain{};
 	std::optional <vk::raii::PipelineLayout> pipelineLayout{};
 	std::optional <vk::raii::Pipeline> graphicsPipeline{};
@@ -51,9 +53,19 @@ public:
 	const std::string& GetBasePath() const { return basePath; };
 	const vk::Extent2D& GetWindowExtent() const { return windowExtent; };
 	const QueueFamilyIndices& GetQueueFamilyIndices() const { return queueFamilyIndices; };
+	bool HasCalibratedTimestamps() const { return hasCalibratedTimestamps; };
+	bool HasMemoryBudget() const { return hasMemoryBudget; };
 
 	void ResetWindowExtent();
 
+	uint32_t FindMemoryType(uint32_t typeFilter, vk::MemoryPropertyFlags properties) const;
+
+	// All device memory goes through these so per-heap and per-category usage stays attributable.
+	KitsuneAllocation AllocateMemory(const vk::MemoryRequirements& requirements, vk::MemoryPropertyFlags properties, MemoryCategory category);
+	KitsuneAllocation AllocateMemory(vk::DeviceSize size, uint32_t memoryTypeIndex, MemoryCategory category);
+	KitsuneMemory& GetMemory() { return memory; }
+	const KitsuneMemory& GetMemory() const { return memory; }
+
 	void WaitForIdle() const
 	{
 		if (resorces.device) {
@@ -61,9 +73,31 @@ public:
 		}
 	}
 
+	// Starts recording a new frame and returns its number. Frame numbers start at 1.
+	// Also refreshes the memory budget, which may invoke the memory pressure callback.
+	uint64_t BeginFrame();
+	uint64_t GetFrameNumber() const { return frameCounter; }
+
+	// Takes ownership of a RAII object that may still be referenced by frames in flight.
+	// It is destroyed once every frame up to the current one has completed, so callers
+	// never need WaitForIdle() to release resources. Objects are released in retire order.
+	template <typename T>
+	void Retire(T&& object)
+	{
+		static_assert(!std::is_lvalue_reference_v<T>, "Retire takes ownership, pass an rvalue");
+		retiredObjects.push_back({ frameCounter, std::make_unique<RetiredHolder<T>>(std::move(object)) });
+	}
+
+	// Call once the fence of `frameNumber` has signaled; frames complete in submission order.
+	void CollectRetired(uint64_t completedFrame);
+	// Releases everything immediately. Only valid after WaitForIdle().
+	void FlushRetired() { retiredObjects.clear(); }
+
 private:
 	bool isRunning{ false };
 	bool hasPortability{ false };
+	bool hasCalibratedTimestamps{ false };
+	bool hasMemoryBudget{ false };
 
 	KitsuneWindowing& windowing_;
 
@@ -72,9 +106,33 @@ private:
 
 	QueueFamilyIndices queueFamilyIndices{ std::nullopt, std::nullopt };
 
+	struct RetiredObject
+	{
+		virtual ~RetiredObject() = default;
+	};
+
+	template <typename T>
+	struct RetiredHolder final : RetiredObject
+	{
+		explicit RetiredHolder(T&& value) : object(std::move(value)) {}
+		T object;
+	};
+
+	struct RetiredEntry
+	{
+		uint64_t frame{ 0 };
+		std::unique_ptr<RetiredObject> object;
+	};
+
+	uint64_t frameCounter{ 0 };
+	// Allocations report back on destruction, so the tracker must outlive retired objects.
+	KitsuneMemory memory;
+	// Declared after `resorces` so anything still queued is released before the device.
+	std::deque<RetiredEntry> retiredObjects;
+
 	void CreateContext();
 	void CreateInstance();
-	void CreateSurface();
+	void CreateSurfaces();
 	void SelectPhysicalDevice();
 	void CreateLogicalDevice();
 
@@ -0,0 +1,195 @@
+#include <kitsune_gpu_timer.hpp>
+#include <kitsune_trace.hpp>
+
+#include <cmath>
+
+namespace {
+
+// Calibrated timestamps drift slowly; refresh the correlation every few seconds.
+constexpr uint32_t RECALIBRATION_INTERVAL = 600;
+
+} // namespace
+
+KitsuneGpuTimer::KitsuneGpuTimer(KitsuneEngine& engine) : engine_(engine) {}
+KitsuneGpuTimer::~KitsuneGpuTimer() {}
+
+void KitsuneGpuTimer::Init()
+{
+    KITSUNE_TRACE_FUNCTION();
+
+    const vk::raii::PhysicalDevice& physicalDevice = *engine_.resorces.physicalDevice;
+    auto families = physicalDevice.getQueueFamilyProperties();
+    uint32_t validBits = families[*engine_.GetQueueFamilyIndices().graphics].timestampValidBits;
+    vk::PhysicalDeviceLimits limits = physicalDevice.getProperties().limits;
+
+    isSupported = validBits > 0 && limits.timestampPeriod > 0.0f;
+    if (!isSupported) {
+        fmt::println("GPU timestamps are not supported on the graphics queue");
+        return;
+    }
+
+    timestampPeriod = limits.timestampPeriod;
+    timestampMask = validBits >= 64 ? ~0ull : (1ull << validBits) - 1;
+
+    vk::QueryPoolCreateInfo poolInfo{};
+    poolInfo.setQueryType(vk::QueryType::eTimestamp)
+        .setQueryCount(MAX_GPU_ZONES_PER_FRAME * 2);
+    for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
+        frames[i].pool.emplace(*engine_.resorces.device, poolInfo);
+        frames[i].frameSlot = i;
+    }
+
+    if (engine_.HasCalibratedTimestamps()) {
+#if defined(_WIN32)
+        hostTimeDomain = vk::TimeDomainKHR::eQueryPerformanceCounter;
+#else
+        hostTimeDomain = vk::TimeDomainKHR::eClockMonotonic;
+#endif
+        auto domains = physicalDevice.getCalibrateableTimeDomainsEXT();
+        useCalibratedTimestamps =
+            std::find(domains.begin(), domains.end(), vk::TimeDomainKHR::eDevice) != domains.end() &&
+            std::find(domains.begin(), domains.end(), hostTimeDomain) != domains.end();
+    }
+
+    Calibrate();
+}
+
+void KitsuneGpuTimer::BeginFrame(const vk::raii::CommandBuffer& cmd, uint32_t frameSlot)
+{
+    recordingFrame = nullptr;
+    if (!isSupported) return;
+
+    FrameQueries& frame = frames[frameSlot];
+    cmd.resetQueryPool(**frame.pool, 0, MAX_GPU_ZONES_PER_FRAME * 2);
+    frame.zoneCount = 0;
+    frame.isPending = true;
+    recordingFrame = &frame;
+}
+
+uint32_t KitsuneGpuTimer::BeginZone(const vk::raii::CommandBuffer& cmd, const char* name, vk::PipelineStageFlags2 stage)
+{
+    if (!recordingFrame || recordingFrame->zoneCount >= MAX_GPU_ZONES_PER_FRAME) return UINT32_MAX;
+
+    uint32_t zone = recordingFrame->zoneCount++;
+    recordingFrame->zoneNames[zone] = name;
+    cmd.writeTimestamp2(stage, **recordingFrame->pool, zone * 2);
+    return zone;
+}
+
+void KitsuneGpuTimer::EndZone(const vk::raii::CommandBuffer& cmd, uint32_t zone, vk::PipelineStageFlags2 stage)
+{
+    if (!recordingFrame || zone >= recordingFrame->zoneCount) return;
+    cmd.writeTimestamp2(stage, **recordingFrame->pool, zone * 2 + 1);
+}
+
+bool KitsuneGpuTimer::CollectFrame(uint32_t frameSlot)
+{
+    if (!isSupported) return false;
+
+    FrameQueries& frame = frames[frameSlot];
+    if (!frame.isPending || frame.zoneCount == 0) return false;
+    frame.isPending = false;
+
+    const uint32_t queryCount = frame.zoneCount * 2;
+    auto [result, ticks] = frame.pool->getResults<uint64_t>(0, queryCount, queryCount * sizeof(uint64_t), sizeof(uint64_t),
+        vk::QueryResultFlagBits::e64);
+    if (result != vk::Result::eSuccess) return false;
+
+    if (useCalibratedTimestamps && ++framesSinceCalibration >= RECALIBRATION_INTERVAL) {
+        Calibrate();
+    }
+
+    lastResults.clear();
+    uint64_t frameBegin = std::numeric_limits<uint64_t>::max();
+    uint64_t frameEnd = 0;
+    for (uint32_t zone = 0; zone < frame.zoneCount; ++zone) {
+        GpuZoneResult zoneResult{};
+        zoneResult.name = frame.zoneNames[zone];
+        zoneResult.beginNs = GpuTicksToNs(ticks[zone * 2] & timestampMask);
+        zoneResult.endNs = std::max(zoneResult.beginNs, GpuTicksToNs(ticks[zone * 2 + 1] & timestampMask));
+        frameBegin = std::min(frameBegin, zoneResult.beginNs);
+        frameEnd = std::max(frameEnd, zoneResult.endNs);
+        lastResults.push_back(zoneResult);
+
+#if defined(KITSUNE_ENABLE_TRACE)
+        KitsuneTrace::RecordGpu(zoneResult.name, zoneResult.beginNs, zoneResult.endNs);
+#endif
+    }
+    lastFrameTimeMs = static_cast<double>(frameEnd - frameBegin) / 1.0e6;
+    return true;
+}
+
+void KitsuneGpuTimer::Calibrate()
+{
+    framesSinceCalibration = 0;
+    if (!useCalibratedTimestamps) {
+        CalibrateWithSubmit();
+        return;
+    }
+
+    std::array<vk::CalibratedTimestampInfoKHR, 2> infos{};
+    infos[0].setTimeDomain(vk::TimeDomainKHR::eDevice);
+    infos[1].setTimeDomain(hostTimeDomain);
+
+    auto [timestamps, maxDeviation] = engine_.resorces.device->getCalibratedTimestampsEXT(infos);
+    calibrationGpuTicks = timestamps[0] & timestampMask;
+    calibrationCpuNs = HostTicksToNs(timestamps[1]);
+}
+
+void KitsuneGpuTimer::CalibrateWithSubmit()
+{
+    // Without VK_EXT_calibrated_timestamps, write one timestamp and pair it with the CPU time
+    // at which its fence is observed. GPU zones end up slightly late by the wake-up latency.
+    const vk::raii::Device& device = *engine_.resorces.device;
+    FrameQueries& frame = frames[0];
+
+    vk::CommandPoolCreateInfo poolInfo{};
+    poolInfo.setQueueFamilyIndex(*engine_.GetQueueFamilyIndices().graphics)
+        .setFlags(vk::CommandPoolCreateFlagBits::eTransient);
+    vk::raii::CommandPool commandPool(device, poolInfo);
+
+    vk::CommandBufferAllocateInfo allocInfo{};
+    allocInfo.setCommandPool(*commandPool)
+        .setLevel(vk::CommandBufferLevel::ePrimary)
+        .setCommandBufferCount(1);
+    vk::raii::CommandBuffer cmd = std::move(device.allocateCommandBuffers(allocInfo).front());
+
+    cmd.begin(vk::CommandBufferBeginInfo{ vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+    cmd.resetQueryPool(**frame.pool, 0, 1);
+    cmd.writeTimestamp2(vk::PipelineStageFlagBits2::eAllCommands, **frame.pool, 0);
+    cmd.end();
+
+    vk::raii::Fence fence(device, vk::FenceCreateInfo{});
+    vk::SubmitInfo submitInfo{};
+    submitInfo.setCommandBufferCount(1)
+        .setPCommandBuffers(&(*cmd));
+    engine_.resorces.graphicsQueue->submit(submitInfo, *fence);
+
+    auto waitResult = device.waitForFences(*fence, VK_TRUE, UINT64_MAX);
+    uint64_t cpuNs = KitsuneTrace::Now();
+
+    auto [result, ticks] = frame.pool->getResults<uint64_t>(0, 1, sizeof(uint64_t), sizeof(uint64_t),
+        vk::QueryResultFlagBits::e64 | vk::QueryResultFlagBits::eWait);
+    calibrationGpuTicks = ticks[0] & timestampMask;
+    calibrationCpuNs = cpuNs;
+}
+
+uint64_t KitsuneGpuTimer::HostTicksToNs(uint64_t ticks) const
+{
+#if defined(_WIN32)
+    // Same split as steady_clock on MSVC so both land on the same nanosecond scale.
+    const uint64_t frequency = SDL_GetPerformanceFrequency();
+    const uint64_t whole = (ticks / frequency) * 1000000000ull;
+    const uint64_t part = (ticks % frequency) * 1000000000ull / frequency;
+    return whole + part;
+#else
+    return ticks;
+#endif
+}
+
+uint64_t KitsuneGpuTimer::GpuTicksToNs(uint64_t ticks) const
+{
+    const int64_t deltaTicks = static_cast<int64_t>(ticks) - static_cast<int64_t>(calibrationGpuTicks);
+    const int64_t deltaNs = static_cast<int64_t>(std::llround(static_cast<double>(deltaTicks) * timestampPeriod));
+    return static_cast<uint64_t>(static_cast<int64_t>(calibrationCpuNs) + deltaNs);
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include <kitsune_types.h>
+#include <kitsune_engine.hpp>
+
+static constexpr uint32_t MAX_GPU_ZONES_PER_FRAME = 32;
+
+struct GpuZoneResult
+{
+	const char* name{ nullptr };
+	// Converted onto the KitsuneTrace clock (steady_clock nanoseconds).
+	uint64_t beginNs{ 0 };
+	uint64_t endNs{ 0 };
+};
+
+// Per-frame-slot timestamp queries. Results are read back once the slot's fence has
+// signaled, so collecting never stalls the GPU or the render thread.
+class KitsuneGpuTimer
+{
+public:
+	explicit KitsuneGpuTimer(KitsuneEngine& engine);
+	~KitsuneGpuTimer();
+
+	void Init();
+	bool IsSupported() const { return isSupported; }
+
+	void BeginFrame(const vk::raii::CommandBuffer& cmd, uint32_t frameSlot);
+	// Returns an id to pass to EndZone, or UINT32_MAX when the zone could not be recorded.
+	uint32_t BeginZone(const vk::raii::CommandBuffer& cmd, const char* name,
+		vk::PipelineStageFlags2 stage = vk::PipelineStageFlagBits2::eTopOfPipe);
+	void EndZone(const vk::raii::CommandBuffer& cmd, uint32_t zone,
+		vk::PipelineStageFlags2 stage = vk::PipelineStageFlagBits2::eBottomOfPipe);
+
+	// Call after the in-flight fence of `frameSlot` has signaled. Returns true when new results were read.
+	bool CollectFrame(uint32_t frameSlot);
+
+	const std::vector<GpuZoneResult>& GetLastResults() const { return lastResults; }
+	// Span of all zones of the last collected frame, in milliseconds.
+	double GetLastFrameTimeMs() const { return lastFrameTimeMs; }
+
+private:
+	struct FrameQueries
+	{
+		std::optional<vk::raii::QueryPool> pool{};
+		std::array<const char*, MAX_GPU_ZONES_PER_FRAME> zoneNames{};
+		uint32_t zoneCount{ 0 };
+		uint32_t frameSlot{ 0 };
+		bool isPending{ false };
+	};
+
+	KitsuneEngine& engine_;
+	std::array<FrameQueries, MAX_FRAMES_IN_FLIGHT> frames{};
+	FrameQueries* recordingFrame{ nullptr };
+
+	bool isSupported{ false };
+	double timestampPeriod{ 1.0 };
+	uint64_t timestampMask{ ~0ull };
+
+	bool useCalibratedTimestamps{ false };
+	vk::TimeDomainKHR hostTimeDomain{ vk::TimeDomainKHR::eDevice };
+	uint64_t calibrationGpuTicks{ 0 };
+	uint64_t calibrationCpuNs{ 0 };
+	uint32_t framesSinceCalibration{ 0 };
+
+	std::vector<GpuZoneResult> lastResults;
+	double lastFrameTimeMs{ 0.0 };
+
+	void Calibrate();
+	void CalibrateWithSubmit();
+	uint64_t HostTicksToNs(uint64_t ticks) const;
+	uint64_t GpuTicksToNs(uint64_t ticks) const;
+};
@@ -0,0 +1,224 @@
+#include <kitsune_memory.hpp>
+#include <kitsune_trace.hpp>
+
+namespace {
+
+double ToMiB(vk::DeviceSize bytes)
+{
+    return static_cast<double>(bytes) / (1024.0 * 1024.0);
+}
+
+} // namespace
+
+const char* ToString(MemoryCategory category)
+{
+    switch (category) {
+    case MemoryCategory::Textures: return "Textures";
+    case MemoryCategory::Buffers: return "Buffers";
+    case MemoryCategory::RenderTargets: return "RenderTargets";
+    case MemoryCategory::Staging: return "Staging";
+    default: return "Unknown";
+    }
+}
+
+const char* ToString(MemoryPressure pressure)
+{
+    switch (pressure) {
+    case MemoryPressure::Normal: return "Normal";
+    case MemoryPressure::Warning: return "Warning";
+    case MemoryPressure::Critical: return "Critical";
+    default: return "Unknown";
+    }
+}
+
+KitsuneAllocation::KitsuneAllocation(KitsuneMemory& tracker, vk::raii::DeviceMemory&& memory, vk::DeviceSize size,
+    uint32_t heapIndex, MemoryCategory category)
+    : tracker(&tracker), memory(std::move(memory)), size(size), heapIndex(heapIndex), category(category)
+{
+    this->tracker->OnAllocated(heapIndex, category, size);
+}
+
+KitsuneAllocation::KitsuneAllocation(KitsuneAllocation&& other) noexcept
+    : tracker(std::exchange(other.tracker, nullptr)), memory(std::move(other.memory)),
+      size(std::exchange(other.size, 0)), heapIndex(other.heapIndex), category(other.category)
+{
+}
+
+KitsuneAllocation& KitsuneAllocation::operator=(KitsuneAllocation&& other) noexcept
+{
+    if (this != &other) {
+        Release();
+        tracker = std::exchange(other.tracker, nullptr);
+        memory = std::move(other.memory);
+        size = std::exchange(other.size, 0);
+        heapIndex = other.heapIndex;
+        category = other.category;
+    }
+    return *this;
+}
+
+KitsuneAllocation::~KitsuneAllocation()
+{
+    Release();
+}
+
+void KitsuneAllocation::Release()
+{
+    memory.clear();
+    if (tracker) {
+        tracker->OnFreed(heapIndex, category, size);
+        tracker = nullptr;
+    }
+    size = 0;
+}
+
+void KitsuneMemory::Init(const vk::raii::PhysicalDevice& physicalDevice, bool hasMemoryBudget)
+{
+    KITSUNE_TRACE_FUNCTION();
+    physicalDevice_ = &physicalDevice;
+
+    vk::PhysicalDeviceMemoryProperties properties = physicalDevice.getMemoryProperties();
+    for (uint32_t i = 0; i < properties.memoryTypeCount; ++i) {
+        typeToHeap[i] = properties.memoryTypes[i].heapIndex;
+    }
+
+    stats = {};
+    stats.hasBudgetExtension = hasMemoryBudget;
+    stats.heaps.resize(properties.memoryHeapCount);
+    for (uint32_t i = 0; i < properties.memoryHeapCount; ++i) {
+        stats.heaps[i].flags = properties.memoryHeaps[i].flags;
+        stats.heaps[i].size = properties.memoryHeaps[i].size;
+    }
+
+    if (!hasMemoryBudget) {
+        fmt::println("VK_EXT_memory_budget is not available, heap budgets are estimated");
+    }
+    UpdateBudget();
+}
+
+KitsuneAllocation KitsuneMemory::Allocate(const vk::raii::Device& device, vk::DeviceSize size, uint32_t memoryTypeIndex,
+    MemoryCategory category)
+{
+    const uint32_t heapIndex = typeToHeap[memoryTypeIndex];
+
+    vk::MemoryAllocateInfo allocInfo{};
+    allocInfo.setAllocationSize(size)
+        .setMemoryTypeIndex(memoryTypeIndex);
+
+    try {
+        return KitsuneAllocation(*this, vk::raii::DeviceMemory(device, allocInfo), size, heapIndex, category);
+    }
+    catch (const vk::SystemError& e) {
+        // Out of memory is the failure we most need to attribute after the fact.
+        ++stats.failedAllocations;
+        fmt::println("Failed to allocate {:.2f} MiB of {} from heap {}: {}", ToMiB(size), ToString(category), heapIndex, e.what());
+        LogStats();
+
+        MemoryHeapStats& heap = stats.heaps[heapIndex];
+        if (heap.pressure != MemoryPressure::Critical) {
+            heap.pressure = MemoryPressure::Critical;
+            if (pressureCallback) pressureCallback(heapIndex, heap.pressure, heap);
+        }
+        throw;
+    }
+}
+
+void KitsuneMemory::UpdateBudget()
+{
+    if (!physicalDevice_) return;
+
+    if (stats.hasBudgetExtension) {
+        auto chain = physicalDevice_->getMemoryProperties2<vk::PhysicalDeviceMemoryProperties2, vk::PhysicalDeviceMemoryBudgetPropertiesEXT>();
+        const auto& budget = chain.get<vk::PhysicalDeviceMemoryBudgetPropertiesEXT>();
+        for (uint32_t i = 0; i < stats.heaps.size(); ++i) {
+            stats.heaps[i].budget = budget.heapBudget[i];
+            stats.heaps[i].usage = budget.heapUsage[i];
+        }
+    }
+    else {
+        for (auto& heap : stats.heaps) {
+            heap.budget = static_cast<vk::DeviceSize>(heap.size * FALLBACK_BUDGET_FRACTION);
+            heap.usage = heap.engineBytes;
+        }
+    }
+
+    for (uint32_t i = 0; i < stats.heaps.size(); ++i) {
+        EvaluatePressure(i);
+    }
+}
+
+void KitsuneMemory::LogStats() const
+{
+    fmt::println("GPU memory ({}):", stats.hasBudgetExtension ? "VK_EXT_memory_budget" : "estimated budget");
+    for (uint32_t i = 0; i < stats.heaps.size(); ++i) {
+        const MemoryHeapStats& heap = stats.heaps[i];
+        fmt::println("  heap {}{}: usage {:.1f} / budget {:.1f} MiB (size {:.1f} MiB), engine {:.1f} MiB in {} allocations, {}",
+            i, (heap.flags & vk::MemoryHeapFlagBits::eDeviceLocal) ? " [device local]" : "",
+            ToMiB(heap.usage), ToMiB(heap.budget), ToMiB(heap.size),
+            ToMiB(heap.engineBytes), heap.engineAllocations, ToString(heap.pressure));
+    }
+    for (uint32_t c = 0; c < MEMORY_CATEGORY_COUNT; ++c) {
+        fmt::println("  {}: {:.1f} MiB in {} allocations",
+            ToString(static_cast<MemoryCategory>(c)), ToMiB(stats.categoryBytes[c]), stats.categoryAllocations[c]);
+    }
+    if (stats.failedAllocations > 0) {
+        fmt::println("  failed allocations: {}", stats.failedAllocations);
+    }
+}
+
+void KitsuneMemory::OnAllocated(uint32_t heapIndex, MemoryCategory category, vk::DeviceSize size)
+{
+    const uint32_t c = static_cast<uint32_t>(category);
+    MemoryHeapStats& heap = stats.heaps[heapIndex];
+    heap.engineBytes += size;
+    heap.engineAllocations++;
+    heap.categoryBytes[c] += size;
+    stats.categoryBytes[c] += size;
+    stats.categoryAllocations[c]++;
+
+    // The driver's usage only refreshes in UpdateBudget(); account for the allocation until then.
+    heap.usage += size;
+    EvaluatePressure(heapIndex);
+}
+
+void KitsuneMemory::OnFreed(uint32_t heapIndex, MemoryCategory category, vk::DeviceSize size)
+{
+    const uint32_t c = static_cast<uint32_t>(category);
+    MemoryHeapStats& heap = stats.heaps[heapIndex];
+    heap.engineBytes -= size;
+    heap.engineAllocations--;
+    heap.categoryBytes[c] -= size;
+    stats.categoryBytes[c] -= size;
+    stats.categoryAllocations[c]--;
+
+    heap.usage -= std::min(heap.usage, size);
+    EvaluatePressure(heapIndex);
+}
+
+void KitsuneMemory::EvaluatePressure(uint32_t heapIndex)
+{
+    MemoryHeapStats& heap = stats.heaps[heapIndex];
+    if (heap.budget == 0) return;
+
+    const double ratio = static_cast<double>(heap.usage) / static_cast<double>(heap.budget);
+    const double warning = pressureSettings.warningThreshold;
+    const double critical = pressureSettings.criticalThreshold;
+    const double hysteresis = pressureSettings.hysteresis;
+
+    // Rising uses the thresholds as-is, falling requires dropping `hysteresis` below them,
+    // so a heap hovering at a threshold does not flood the callback.
+    MemoryPressure pressure = MemoryPressure::Normal;
+    if (ratio >= critical || (heap.pressure == MemoryPressure::Critical && ratio >= critical - hysteresis)) {
+        pressure = MemoryPressure::Critical;
+    }
+    else if (ratio >= warning || (heap.pressure != MemoryPressure::Normal && ratio >= warning - hysteresis)) {
+        pressure = MemoryPressure::Warning;
+    }
+
+    if (pressure != heap.pressure) {
+        heap.pressure = pressure;
+        fmt::println("GPU memory heap {} pressure: {} ({:.1f} / {:.1f} MiB)", heapIndex, ToString(pressure),
+            ToMiB(heap.usage), ToMiB(heap.budget));
+        if (pressureCallback) pressureCallback(heapIndex, pressure, heap);
+    }
+}
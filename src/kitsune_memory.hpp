@@ -0,0 +1,126 @@
+#pragma once
+#include <kitsune_types.h>
+
+enum class MemoryCategory : uint32_t
+{
+	Textures,
+	Buffers,
+	RenderTargets,
+	Staging,
+	Count
+};
+
+static constexpr uint32_t MEMORY_CATEGORY_COUNT = static_cast<uint32_t>(MemoryCategory::Count);
+
+const char* ToString(MemoryCategory category);
+
+enum class MemoryPressure : uint32_t
+{
+	Normal,
+	Warning,
+	Critical
+};
+
+const char* ToString(MemoryPressure pressure);
+
+struct MemoryHeapStats
+{
+	vk::MemoryHeapFlags flags{};
+	vk::DeviceSize size{ 0 };
+	// From VK_EXT_memory_budget when available: usage is process-wide (including memory the
+	// driver allocates for us) and budget accounts for other processes. Without the extension
+	// usage is what the engine allocated and budget is a fixed fraction of the heap size.
+	vk::DeviceSize budget{ 0 };
+	vk::DeviceSize usage{ 0 };
+
+	vk::DeviceSize engineBytes{ 0 };
+	uint32_t engineAllocations{ 0 };
+	std::array<vk::DeviceSize, MEMORY_CATEGORY_COUNT> categoryBytes{};
+
+	MemoryPressure pressure{ MemoryPressure::Normal };
+};
+
+struct MemoryStats
+{
+	bool hasBudgetExtension{ false };
+	std::vector<MemoryHeapStats> heaps;
+	std::array<vk::DeviceSize, MEMORY_CATEGORY_COUNT> categoryBytes{};
+	std::array<uint32_t, MEMORY_CATEGORY_COUNT> categoryAllocations{};
+	uint64_t failedAllocations{ 0 };
+};
+
+struct MemoryPressureSettings
+{
+	// Fractions of the heap budget. A heap leaves a level once usage drops `hysteresis` below it.
+	float warningThreshold{ 0.85f };
+	float criticalThreshold{ 0.95f };
+	float hysteresis{ 0.05f };
+};
+
+// Called on the render thread whenever a heap changes pressure level, including back to Normal.
+using MemoryPressureCallback = std::function<void(uint32_t heapIndex, MemoryPressure pressure, const MemoryHeapStats& heap)>;
+
+class KitsuneMemory;
+
+// Device memory that reports itself to KitsuneMemory for its whole lifetime.
+// Move-only; can be handed to KitsuneEngine::Retire like any RAII object.
+class KitsuneAllocation
+{
+public:
+	KitsuneAllocation(KitsuneMemory& tracker, vk::raii::DeviceMemory&& memory, vk::DeviceSize size,
+		uint32_t heapIndex, MemoryCategory category);
+	KitsuneAllocation(KitsuneAllocation&& other) noexcept;
+	KitsuneAllocation& operator=(KitsuneAllocation&& other) noexcept;
+	KitsuneAllocation(const KitsuneAllocation&) = delete;
+	KitsuneAllocation& operator=(const KitsuneAllocation&) = delete;
+	~KitsuneAllocation();
+
+	const vk::raii::DeviceMemory& GetMemory() const { return memory; }
+	vk::DeviceSize GetSize() const { return size; }
+	MemoryCategory GetCategory() const { return category; }
+
+private:
+	KitsuneMemory* tracker{ nullptr };
+	vk::raii::DeviceMemory memory{ nullptr };
+	vk::DeviceSize size{ 0 };
+	uint32_t heapIndex{ 0 };
+	MemoryCategory category{ MemoryCategory::Buffers };
+
+	void Release();
+};
+
+// Per-heap usage and budget tracking. Allocations and frees are counted as they happen;
+// UpdateBudget() refreshes the driver's numbers once per frame.
+class KitsuneMemory
+{
+public:
+	void Init(const vk::raii::PhysicalDevice& physicalDevice, bool hasMemoryBudget);
+
+	// Throws like vk::raii::DeviceMemory on failure, after logging the stats of the failing heap.
+	KitsuneAllocation Allocate(const vk::raii::Device& device, vk::DeviceSize size, uint32_t memoryTypeIndex,
+		MemoryCategory category);
+
+	void UpdateBudget();
+
+	const MemoryStats& GetStats() const { return stats; }
+	void LogStats() const;
+
+	void SetPressureCallback(MemoryPressureCallback callback) { pressureCallback = std::move(callback); }
+	void SetPressureSettings(const MemoryPressureSettings& settings) { pressureSettings = settings; }
+
+private:
+	friend class KitsuneAllocation;
+
+	// Budget assumed for each heap when VK_EXT_memory_budget is missing.
+	static constexpr float FALLBACK_BUDGET_FRACTION = 0.8f;
+
+	const vk::raii::PhysicalDevice* physicalDevice_{ nullptr };
+	std::array<uint32_t, VK_MAX_MEMORY_TYPES> typeToHeap{};
+	MemoryStats stats{};
+	MemoryPressureSettings pressureSettings{};
+	MemoryPressureCallback pressureCallback{};
+
+	void OnAllocated(uint32_t heapIndex, MemoryCategory category, vk::DeviceSize size);
+	void OnFreed(uint32_t heapIndex, MemoryCategory category, vk::DeviceSize size);
+	void EvaluatePressure(uint32_t heapIndex);
+};
@@ -0,0 +1,66 @@
+#pragma once
+// On-disk layout of cooked mesh packages (.kmesh) written by kitsune_cook.
+// Kept free of Vulkan/SDL includes so the cooker can be built without them.
+#include <cstdint>
+
+static constexpr uint32_t MESH_PACKAGE_MAGIC = 0x48534D4B; // "KMSH"
+static constexpr uint32_t MESH_PACKAGE_VERSION = 1;
+
+static constexpr uint32_t MESHLET_MAX_VERTICES = 64;
+static constexpr uint32_t MESHLET_MAX_TRIANGLES = 124;
+
+// File layout: MeshPackageHeader, then each section at its recorded offset:
+//   PackedVertex[vertexCount]
+//   uint32_t[indexCount]                  post-transform cache ordered triangle list
+//   MeshletDesc[meshletCount]
+//   uint32_t[meshletVertexCount]          meshlet-local vertex -> vertex buffer index
+//   uint8_t[meshletTriangleCount * 3]     meshlet-local triangle corners
+struct MeshPackageHeader
+{
+	uint32_t magic{ MESH_PACKAGE_MAGIC };
+	uint32_t version{ MESH_PACKAGE_VERSION };
+	// Hash of the source file, cook options and cooker version; unchanged inputs are skipped.
+	uint64_t sourceHash{ 0 };
+
+	uint32_t vertexCount{ 0 };
+	uint32_t indexCount{ 0 };
+	uint32_t meshletCount{ 0 };
+	uint32_t meshletVertexCount{ 0 };
+	uint32_t meshletTriangleCount{ 0 };
+	uint32_t vertexStride{ 0 };
+
+	// Positions are stored as unorm16 inside this box.
+	float boundsMin[3]{};
+	float boundsMax[3]{};
+
+	uint64_t vertexOffset{ 0 };
+	uint64_t indexOffset{ 0 };
+	uint64_t meshletOffset{ 0 };
+	uint64_t meshletVertexOffset{ 0 };
+	uint64_t meshletTriangleOffset{ 0 };
+};
+
+// 16 bytes instead of 32 for float position/normal/uv.
+struct PackedVertex
+{
+	uint16_t position[3]{};  // unorm16, dequantize with boundsMin/boundsMax
+	uint16_t padding{ 0 };
+	int16_t normal[2]{};     // octahedral-encoded snorm16
+	uint16_t uv[2]{};        // IEEE half floats
+};
+
+struct MeshletDesc
+{
+	uint32_t vertexOffset{ 0 };    // into the meshlet vertex section
+	uint32_t triangleOffset{ 0 };  // in triangles, into the meshlet triangle section
+	uint32_t vertexCount{ 0 };
+	uint32_t triangleCount{ 0 };
+
+	// Bounding sphere and normal cone for cluster culling. A cone cutoff of 1 disables cone culling.
+	float center[3]{};
+	float radius{ 0.0f };
+	float coneAxis[3]{};
+	float coneCutoff{ 1.0f };
+};
+
+static_assert(sizeof(PackedVertex) == 16, "PackedVertex layout changed");
@@ -0,0 +1,369 @@
+#include <kitsune_readback.hpp>
+#include <kitsune_trace.hpp>
+
+#include <filesystem>
+
+namespace {
+
+constexpr uint32_t RAW_IMAGE_MAGIC = 0x5741524B; // "KRAW"
+constexpr uint32_t RAW_IMAGE_VERSION = 1;
+
+struct RawImageHeader
+{
+    uint32_t magic{ RAW_IMAGE_MAGIC };
+    uint32_t version{ RAW_IMAGE_VERSION };
+    uint32_t width{ 0 };
+    uint32_t height{ 0 };
+    uint32_t format{ 0 };
+    uint32_t rowPitch{ 0 };
+};
+
+struct RawImage
+{
+    RawImageHeader header{};
+    std::vector<std::byte> pixels;
+};
+
+std::optional<RawImage> ReadRawImage(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) return std::nullopt;
+
+    RawImage image{};
+    file.read(reinterpret_cast<char*>(&image.header), sizeof(image.header));
+    if (!file || image.header.magic != RAW_IMAGE_MAGIC || image.header.version != RAW_IMAGE_VERSION) {
+        return std::nullopt;
+    }
+
+    image.pixels.resize(static_cast<size_t>(image.header.rowPitch) * image.header.height);
+    file.read(reinterpret_cast<char*>(image.pixels.data()), static_cast<std::streamsize>(image.pixels.size()));
+    if (!file) return std::nullopt;
+    return image;
+}
+
+} // namespace
+
+bool WriteRawImage(const std::string& path, const CapturedFrame& frame)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) return false;
+
+    RawImageHeader header{};
+    header.width = frame.extent.width;
+    header.height = frame.extent.height;
+    header.format = static_cast<uint32_t>(frame.format);
+    header.rowPitch = frame.rowPitch;
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(frame.pixels.data()), static_cast<std::streamsize>(frame.pixels.size()));
+    return static_cast<bool>(file);
+}
+
+ReadbackSink MakeRawFileSink(const std::string& directory)
+{
+    std::filesystem::create_directories(directory);
+    return [directory](const CapturedFrame& frame) {
+        std::string path = fmt::format("{}/frame_{:06}.raw", directory, frame.frameNumber);
+        if (!WriteRawImage(path, frame)) {
+            fmt::println("Failed to write capture: {}", path);
+        }
+    };
+}
+
+ReadbackSink MakeImageCompareSink(const std::string& goldenPath, ImageCompareOptions options,
+    std::function<void(const ImageCompareResult&)> onResult)
+{
+    // The golden image is loaded lazily on the worker thread and shared between invocations.
+    auto golden = std::make_shared<std::optional<RawImage>>();
+
+    return [goldenPath, options, onResult = std::move(onResult), golden](const CapturedFrame& frame) {
+        ImageCompareResult result{};
+        result.frameNumber = frame.frameNumber;
+
+        if (!golden->has_value()) {
+            *golden = ReadRawImage(goldenPath);
+        }
+
+        if (!golden->has_value()) {
+            if (options.writeGoldenIfMissing && WriteRawImage(goldenPath, frame)) {
+                *golden = ReadRawImage(goldenPath);
+                result.passed = true;
+                result.message = fmt::format("Golden image written: {}", goldenPath);
+            }
+            else {
+                result.message = fmt::format("Golden image missing: {}", goldenPath);
+            }
+            onResult(result);
+            return;
+        }
+
+        const RawImageHeader& header = (*golden)->header;
+        if (header.width != frame.extent.width || header.height != frame.extent.height ||
+            header.format != static_cast<uint32_t>(frame.format)) {
+            result.message = fmt::format("Golden image is {}x{} ({}), capture is {}x{} ({})",
+                header.width, header.height, vk::to_string(static_cast<vk::Format>(header.format)),
+                frame.extent.width, frame.extent.height, vk::to_string(frame.format));
+            onResult(result);
+            return;
+        }
+
+        // Channels are compared as raw unsigned integers of the format's channel size.
+        const uint32_t channelSize = GetReadbackChannelSize(frame.format);
+        if (channelSize == 0) {
+            result.message = fmt::format("Unsupported capture format {}", vk::to_string(frame.format));
+            onResult(result);
+            return;
+        }
+
+        auto readChannel = [channelSize](const std::byte* data) -> uint32_t {
+            if (channelSize == 1) return static_cast<uint32_t>(data[0]);
+            uint16_t value;
+            std::memcpy(&value, data, sizeof(value));
+            return value;
+        };
+
+        const std::byte* expected = (*golden)->pixels.data();
+        const size_t texelSize = static_cast<size_t>(channelSize) * 4;
+        const size_t rowBytes = static_cast<size_t>(frame.extent.width) * texelSize;
+        for (uint32_t y = 0; y < frame.extent.height; ++y) {
+            const std::byte* expectedRow = expected + static_cast<size_t>(y) * header.rowPitch;
+            const std::byte* actualRow = frame.pixels.data() + static_cast<size_t>(y) * frame.rowPitch;
+            for (size_t x = 0; x < rowBytes; x += texelSize) {
+                uint32_t pixelDelta = 0;
+                for (size_t c = 0; c < texelSize; c += channelSize) {
+                    int delta = std::abs(static_cast<int>(readChannel(expectedRow + x + c)) - static_cast<int>(readChannel(actualRow + x + c)));
+                    pixelDelta = std::max(pixelDelta, static_cast<uint32_t>(delta));
+                }
+                result.maxChannelDelta = std::max(result.maxChannelDelta, pixelDelta);
+                if (pixelDelta > options.channelTolerance) ++result.mismatchedPixels;
+            }
+        }
+
+        const double pixelCount = static_cast<double>(frame.extent.width) * frame.extent.height;
+        const double mismatchRatio = pixelCount > 0.0 ? static_cast<double>(result.mismatchedPixels) / pixelCount : 0.0;
+        result.passed = mismatchRatio <= options.maxMismatchRatio;
+        result.message = fmt::format("{} mismatched pixels ({:.4f}%), max channel delta {}",
+            result.mismatchedPixels, mismatchRatio * 100.0, result.maxChannelDelta);
+        onResult(result);
+    };
+}
+
+
+KitsuneReadback::KitsuneReadback(KitsuneEngine& engine, uint32_t slotCount) : engine_(engine)
+{
+    slots.reserve(slotCount);
+    for (uint32_t i = 0; i < slotCount; ++i) {
+        slots.push_back(std::make_unique<Slot>());
+    }
+    worker = std::thread([this] { WorkerLoop(); });
+}
+
+KitsuneReadback::~KitsuneReadback()
+{
+    {
+        std::lock_guard lock(queueMutex);
+        stopWorker = true;
+    }
+    queueCondition.notify_all();
+    if (worker.joinable()) worker.join();
+}
+
+void KitsuneReadback::AddSink(ReadbackSink sink)
+{
+    std::lock_guard lock(sinkMutex);
+    sinks.push_back(std::move(sink));
+}
+
+uint32_t GetReadbackChannelSize(vk::Format format)
+{
+    switch (format) {
+    case vk::Format::eR8G8B8A8Unorm:
+    case vk::Format::eR8G8B8A8Srgb:
+    case vk::Format::eB8G8R8A8Unorm:
+    case vk::Format::eB8G8R8A8Srgb:
+    case vk::Format::eA8B8G8R8UnormPack32:
+    case vk::Format::eA8B8G8R8SrgbPack32:
+        return 1;
+    case vk::Format::eR16G16B16A16Unorm:
+    case vk::Format::eR16G16B16A16Sfloat:
+        return 2;
+    default:
+        return 0;
+    }
+}
+
+void KitsuneReadback::RequestCapture(uint32_t frameCount, uint32_t interval)
+{
+    pendingCaptures = frameCount;
+    captureInterval = std::max(interval, 1u);
+    lastCaptureFrame.reset();
+}
+
+void KitsuneReadback::CancelCapture()
+{
+    pendingCaptures = 0;
+}
+
+bool KitsuneReadback::WantsCapture(uint64_t frameNumber) const
+{
+    if (pendingCaptures == 0) return false;
+    return !lastCaptureFrame || frameNumber - *lastCaptureFrame >= captureInterval;
+}
+
+bool KitsuneReadback::RecordCopy(const vk::raii::CommandBuffer& cmd, vk::Image image, vk::Extent2D extent, vk::Format format,
+    uint32_t frameSlot, uint64_t frameNumber)
+{
+    const uint32_t channelSize = GetReadbackChannelSize(format);
+    if (channelSize == 0) {
+        fmt::println("Readback does not support {}, capture cancelled", vk::to_string(format));
+        CancelCapture();
+        return false;
+    }
+
+    auto it = std::find_if(slots.begin(), slots.end(),
+        [](const auto& slot) { return slot->state.load(std::memory_order_acquire) == SlotState::Free; });
+    if (it == slots.end()) return false;
+
+    Slot& slot = **it;
+    const uint32_t rowPitch = extent.width * channelSize * 4;
+    const vk::DeviceSize size = static_cast<vk::DeviceSize>(rowPitch) * extent.height;
+    if (slot.capacity < size) {
+        AllocateSlot(slot, size);
+    }
+
+    vk::BufferImageCopy region{};
+    region.setBufferOffset(0)
+        .setBufferRowLength(0)
+        .setBufferImageHeight(0)
+        .setImageSubresource({ vk::ImageAspectFlagBits::eColor, 0, 0, 1 })
+        .setImageOffset({ 0, 0, 0 })
+        .setImageExtent({ extent.width, extent.height, 1 });
+    cmd.copyImageToBuffer(image, vk::ImageLayout::eTransferSrcOptimal, **slot.buffer, region);
+
+    vk::BufferMemoryBarrier2 barrier{};
+    barrier.setSrcStageMask(vk::PipelineStageFlagBits2::eCopy)
+        .setSrcAccessMask(vk::AccessFlagBits2::eTransferWrite)
+        .setDstStageMask(vk::PipelineStageFlagBits2::eHost)
+        .setDstAccessMask(vk::AccessFlagBits2::eHostRead)
+        .setSrcQueueFamilyIndex(vk::QueueFamilyIgnored)
+        .setDstQueueFamilyIndex(vk::QueueFamilyIgnored)
+        .setBuffer(**slot.buffer)
+        .setOffset(0)
+        .setSize(size);
+
+    vk::DependencyInfo dependency{};
+    dependency.setBufferMemoryBarrierCount(1)
+        .setPBufferMemoryBarriers(&barrier);
+    cmd.pipelineBarrier2(dependency);
+
+    slot.frameSlot = frameSlot;
+    slot.frame.frameNumber = frameNumber;
+    slot.frame.extent = extent;
+    slot.frame.format = format;
+    slot.frame.rowPitch = rowPitch;
+    slot.frame.pixels = std::span<const std::byte>(slot.mapped, static_cast<size_t>(size));
+    slot.state.store(SlotState::InFlight, std::memory_order_release);
+
+    --pendingCaptures;
+    lastCaptureFrame = frameNumber;
+    return true;
+}
+
+void KitsuneReadback::OnFrameCompleted(uint32_t frameSlot)
+{
+    bool queued = false;
+    {
+        std::lock_guard lock(queueMutex);
+        for (auto& slot : slots) {
+            if (slot->state.load(std::memory_order_acquire) == SlotState::InFlight && slot->frameSlot == frameSlot) {
+                slot->state.store(SlotState::Queued, std::memory_order_release);
+                workQueue.push_back(slot.get());
+                queued = true;
+            }
+        }
+    }
+    if (queued) queueCondition.notify_one();
+}
+
+void KitsuneReadback::OnDeviceIdle()
+{
+    for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
+        OnFrameCompleted(i);
+    }
+    WaitForWorker();
+}
+
+void KitsuneReadback::AllocateSlot(Slot& slot, vk::DeviceSize size)
+{
+    // Only free slots are reallocated, so neither the GPU nor the worker can still reference them.
+    slot.mapped = nullptr;
+    slot.memory.reset();
+    slot.buffer.reset();
+    slot.capacity = 0;
+
+    const vk::raii::Device& device = *engine_.resorces.device;
+
+    vk::BufferCreateInfo bufferInfo{};
+    bufferInfo.setSize(size)
+        .setUsage(vk::BufferUsageFlagBits::eTransferDst)
+        .setSharingMode(vk::SharingMode::eExclusive);
+    slot.buffer.emplace(device, bufferInfo);
+
+    vk::MemoryRequirements requirements = slot.buffer->getMemoryRequirements();
+
+    // Prefer cached memory: the worker reads every byte on the CPU.
+    uint32_t memoryType = 0;
+    try {
+        memoryType = engine_.FindMemoryType(requirements.memoryTypeBits,
+            vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent | vk::MemoryPropertyFlagBits::eHostCached);
+    }
+    catch (const std::runtime_error&) {
+        memoryType = engine_.FindMemoryType(requirements.memoryTypeBits,
+            vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+    }
+
+    slot.memory.emplace(engine_.AllocateMemory(requirements.size, memoryType, MemoryCategory::Staging));
+    slot.buffer->bindMemory(*slot.memory->GetMemory(), 0);
+
+    slot.mapped = static_cast<const std::byte*>(slot.memory->GetMemory().mapMemory(0, VK_WHOLE_SIZE));
+    slot.capacity = size;
+}
+
+void KitsuneReadback::WaitForWorker()
+{
+    std::unique_lock lock(queueMutex);
+    idleCondition.wait(lock, [this] { return workQueue.empty() && !isBusy; });
+}
+
+void KitsuneReadback::WorkerLoop()
+{
+    KITSUNE_TRACE_THREAD_NAME("Readback worker");
+
+    while (true) {
+        Slot* slot = nullptr;
+        {
+            std::unique_lock lock(queueMutex);
+            queueCondition.wait(lock, [this] { return stopWorker || !workQueue.empty(); });
+            if (workQueue.empty()) return;
+
+            slot = workQueue.front();
+            workQueue.pop_front();
+            isBusy = true;
+        }
+
+        {
+            KITSUNE_TRACE_ZONE("Readback sinks");
+            std::lock_guard lock(sinkMutex);
+            for (const auto& sink : sinks) {
+                sink(slot->frame);
+            }
+        }
+
+        slot->state.store(SlotState::Free, std::memory_order_release);
+        {
+            std::lock_guard lock(queueMutex);
+            isBusy = false;
+        }
+        idleCondition.notify_all();
+    }
+}
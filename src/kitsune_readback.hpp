@@ -0,0 +1,122 @@
+#pragma once
+#include <kitsune_types.h>
+#include <kitsune_engine.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+
+struct CapturedFrame
+{
+	uint64_t frameNumber{ 0 };
+	vk::Extent2D extent{ 0, 0 };
+	vk::Format format{ vk::Format::eUndefined };
+	uint32_t rowPitch{ 0 };
+	std::span<const std::byte> pixels{};
+};
+
+// Sinks run on the readback worker thread, never on the render thread.
+using ReadbackSink = std::function<void(const CapturedFrame&)>;
+
+struct ImageCompareResult
+{
+	uint64_t frameNumber{ 0 };
+	uint64_t mismatchedPixels{ 0 };
+	uint32_t maxChannelDelta{ 0 };
+	bool passed{ false };
+	std::string message;
+};
+
+struct ImageCompareOptions
+{
+	uint32_t channelTolerance{ 2 };
+	double maxMismatchRatio{ 0.0 };
+	// Off by default so a missing golden image fails the check instead of silently becoming the reference.
+	bool writeGoldenIfMissing{ false };
+};
+
+// Writes each captured frame to `<directory>/frame_<number>.raw`.
+ReadbackSink MakeRawFileSink(const std::string& directory);
+
+// Compares each captured frame against a golden raw file written by MakeRawFileSink.
+ReadbackSink MakeImageCompareSink(const std::string& goldenPath, ImageCompareOptions options,
+	std::function<void(const ImageCompareResult&)> onResult);
+
+bool WriteRawImage(const std::string& path, const CapturedFrame& frame);
+
+// Bytes per channel of a four-channel color format readback can copy and compare,
+// or 0 when the format is not supported (packed, compressed, depth...).
+uint32_t GetReadbackChannelSize(vk::Format format);
+inline bool IsReadbackFormatSupported(vk::Format format) { return GetReadbackChannelSize(format) != 0; }
+
+
+// Copies selected frames into a ring of host-visible buffers and hands them to a
+// worker thread once the frame's fence has signaled. The render thread never waits:
+// if every ring slot is still busy the capture is simply postponed.
+class KitsuneReadback
+{
+public:
+	explicit KitsuneReadback(KitsuneEngine& engine, uint32_t slotCount = READBACK_RING_SIZE);
+	~KitsuneReadback();
+
+	KitsuneReadback(const KitsuneReadback&) = delete;
+	KitsuneReadback& operator=(const KitsuneReadback&) = delete;
+
+	void AddSink(ReadbackSink sink);
+
+	// Captures the next `frameCount` frames, one every `interval` frames.
+	void RequestCapture(uint32_t frameCount = 1, uint32_t interval = 1);
+	void CancelCapture();
+	bool WantsCapture(uint64_t frameNumber) const;
+	// True while requested frames remain to be captured; on-demand rendering keeps drawing until then.
+	bool HasPendingCaptures() const { return pendingCaptures > 0; }
+
+	// Records a copy of `image` into a free ring slot. The image must be in eTransferSrcOptimal.
+	// Returns false when no slot is free, in which case nothing is recorded. Captures of a format
+	// IsReadbackFormatSupported() rejects are cancelled.
+	bool RecordCopy(const vk::raii::CommandBuffer& cmd, vk::Image image, vk::Extent2D extent, vk::Format format,
+		uint32_t frameSlot, uint64_t frameNumber);
+
+	// Call after the in-flight fence of `frameSlot` has signaled.
+	void OnFrameCompleted(uint32_t frameSlot);
+	// Call after the device went idle; releases every in-flight copy and waits for the sinks.
+	void OnDeviceIdle();
+
+private:
+	enum class SlotState : uint32_t { Free, InFlight, Queued };
+
+	struct Slot
+	{
+		std::optional<vk::raii::Buffer> buffer{};
+		std::optional<KitsuneAllocation> memory{};
+		const std::byte* mapped{ nullptr };
+		vk::DeviceSize capacity{ 0 };
+		std::atomic<SlotState> state{ SlotState::Free };
+		uint32_t frameSlot{ 0 };
+		CapturedFrame frame{};
+	};
+
+	KitsuneEngine& engine_;
+	std::vector<std::unique_ptr<Slot>> slots;
+
+	uint32_t pendingCaptures{ 0 };
+	uint32_t captureInterval{ 1 };
+	std::optional<uint64_t> lastCaptureFrame{};
+
+	std::vector<ReadbackSink> sinks;
+	std::mutex sinkMutex;
+
+	std::deque<Slot*> workQueue;
+	std::mutex queueMutex;
+	std::condition_variable queueCondition;
+	std::condition_variable idleCondition;
+	bool isBusy{ false };
+	bool stopWorker{ false };
+	std::thread worker;
+
+	void AllocateSlot(Slot& slot, vk::DeviceSize size);
+	void WaitForWorker();
+	void WorkerLoop();
+};
@@ -0,0 +1,198 @@
+#include <kitsune_render_queue.hpp>
+#include <kitsune_trace.hpp>
+
+#include <cmath>
+
+uint32_t RenderKey::Depth(float normalizedDepth, bool backToFront)
+{
+    constexpr uint32_t maxDepth = (1u << DEPTH_BITS) - 1;
+    const float clamped = std::clamp(normalizedDepth, 0.0f, 1.0f);
+    const uint32_t depth = static_cast<uint32_t>(std::lround(clamped * static_cast<float>(maxDepth)));
+    return backToFront ? maxDepth - depth : depth;
+}
+
+void RadixSort(std::vector<RenderSortEntry>& entries, std::vector<RenderSortEntry>& scratch)
+{
+    const size_t count = entries.size();
+    if (count < 2) return;
+    scratch.resize(count);
+
+    // One histogram per key byte, all built in a single pass over the input.
+    std::array<std::array<uint32_t, 256>, 8> histograms{};
+    for (const auto& entry : entries) {
+        for (uint32_t byte = 0; byte < 8; ++byte) {
+            ++histograms[byte][(entry.key >> (byte * 8)) & 0xFF];
+        }
+    }
+
+    RenderSortEntry* source = entries.data();
+    RenderSortEntry* destination = scratch.data();
+    for (uint32_t byte = 0; byte < 8; ++byte) {
+        auto& histogram = histograms[byte];
+        const uint32_t shift = byte * 8;
+        if (histogram[(source[0].key >> shift) & 0xFF] == count) continue;
+
+        uint32_t offset = 0;
+        for (auto& bucket : histogram) {
+            uint32_t bucketCount = bucket;
+            bucket = offset;
+            offset += bucketCount;
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+            destination[histogram[(source[i].key >> shift) & 0xFF]++] = source[i];
+        }
+        std::swap(source, destination);
+    }
+
+    if (source != entries.data()) {
+        entries.swap(scratch);
+    }
+}
+
+void KitsuneRenderQueue::Clear()
+{
+    packets.clear();
+    sortedEntries.clear();
+    isSorted = true;
+    ++generation;
+}
+
+void KitsuneRenderQueue::Submit(const DrawPacket& packet)
+{
+    sortedEntries.push_back({ packet.key, static_cast<uint32_t>(packets.size()) });
+    packets.push_back(packet);
+    isSorted = false;
+    ++generation;
+}
+
+void KitsuneRenderQueue::Sort()
+{
+    if (isSorted) return;
+    KITSUNE_TRACE_ZONE("RenderQueue::Sort");
+    RadixSort(sortedEntries, scratchEntries);
+    isSorted = true;
+}
+
+void KitsuneRenderQueue::Record(const vk::raii::CommandBuffer& cmd, const vk::Viewport& viewport, const vk::Rect2D& scissor)
+{
+    KITSUNE_TRACE_ZONE("RenderQueue::Record");
+    Sort();
+
+    RenderQueueStats stats{};
+    if (packets.empty()) {
+        lastStats = stats;
+        return;
+    }
+
+    cmd.setViewport(0, viewport);
+    cmd.setScissor(0, scissor);
+
+    // Nothing is assumed bound at the start of a rendering scope.
+    vk::Pipeline boundPipeline{};
+    vk::PipelineLayout boundLayout{};
+    std::array<vk::DescriptorSet, MAX_PACKET_DESCRIPTOR_SETS> boundSets{};
+    std::optional<vk::CullModeFlags> boundCullMode{};
+    std::optional<vk::FrontFace> boundFrontFace{};
+    std::optional<vk::PrimitiveTopology> boundTopology{};
+    vk::Buffer boundVertexBuffer{};
+    vk::DeviceSize boundVertexOffset{ 0 };
+    vk::Buffer boundIndexBuffer{};
+    vk::DeviceSize boundIndexOffset{ 0 };
+    vk::IndexType boundIndexType{ vk::IndexType::eUint32 };
+
+    for (const auto& entry : sortedEntries) {
+        const DrawPacket& packet = packets[entry.index];
+
+        if (packet.pipeline != boundPipeline) {
+            cmd.bindPipeline(vk::PipelineBindPoint::eGraphics, packet.pipeline);
+            boundPipeline = packet.pipeline;
+            ++stats.pipelineBinds;
+        }
+        else {
+            ++stats.redundantSkipped;
+        }
+
+        if (packet.descriptorSetCount > 0) {
+            // Sets stay valid across pipelines with compatible layouts; a new layout rebinds all of them.
+            uint32_t firstChanged = 0;
+            if (packet.layout == boundLayout) {
+                while (firstChanged < packet.descriptorSetCount && packet.descriptorSets[firstChanged] == boundSets[firstChanged]) {
+                    ++firstChanged;
+                }
+            }
+            if (firstChanged < packet.descriptorSetCount) {
+                const uint32_t changedCount = packet.descriptorSetCount - firstChanged;
+                cmd.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, packet.layout, firstChanged,
+                    vk::ArrayProxy<const vk::DescriptorSet>(changedCount, packet.descriptorSets.data() + firstChanged), {});
+                std::copy_n(packet.descriptorSets.begin() + firstChanged, changedCount, boundSets.begin() + firstChanged);
+                if (packet.layout != boundLayout) {
+                    // Sets past this packet's count were bound against the old layout; forget them.
+                    std::fill(boundSets.begin() + packet.descriptorSetCount, boundSets.end(), vk::DescriptorSet{});
+                    boundLayout = packet.layout;
+                }
+                ++stats.descriptorSetBinds;
+            }
+            else {
+                ++stats.redundantSkipped;
+            }
+        }
+
+        if (boundCullMode != packet.cullMode) {
+            cmd.setCullMode(packet.cullMode);
+            boundCullMode = packet.cullMode;
+            ++stats.dynamicStateChanges;
+        }
+        else {
+            ++stats.redundantSkipped;
+        }
+        if (boundFrontFace != packet.frontFace) {
+            cmd.setFrontFace(packet.frontFace);
+            boundFrontFace = packet.frontFace;
+            ++stats.dynamicStateChanges;
+        }
+        else {
+            ++stats.redundantSkipped;
+        }
+        if (boundTopology != packet.topology) {
+            cmd.setPrimitiveTopology(packet.topology);
+            boundTopology = packet.topology;
+            ++stats.dynamicStateChanges;
+        }
+        else {
+            ++stats.redundantSkipped;
+        }
+
+        if (packet.vertexBuffer) {
+            if (packet.vertexBuffer != boundVertexBuffer || packet.vertexBufferOffset != boundVertexOffset) {
+                cmd.bindVertexBuffers(0, packet.vertexBuffer, packet.vertexBufferOffset);
+                boundVertexBuffer = packet.vertexBuffer;
+                boundVertexOffset = packet.vertexBufferOffset;
+                ++stats.bufferBinds;
+            }
+            else {
+                ++stats.redundantSkipped;
+            }
+        }
+
+        if (packet.indexBuffer) {
+            if (packet.indexBuffer != boundIndexBuffer || packet.indexBufferOffset != boundIndexOffset || packet.indexType != boundIndexType) {
+                cmd.bindIndexBuffer(packet.indexBuffer, packet.indexBufferOffset, packet.indexType);
+                boundIndexBuffer = packet.indexBuffer;
+                boundIndexOffset = packet.indexBufferOffset;
+                boundIndexType = packet.indexType;
+                ++stats.bufferBinds;
+            }
+            else {
+                ++stats.redundantSkipped;
+            }
+            cmd.drawIndexed(packet.count, packet.instanceCount, packet.first, packet.vertexOffset, packet.firstInstance);
+        }
+        else {
+            cmd.draw(packet.count, packet.instanceCount, packet.first, packet.firstInstance);
+        }
+        ++stats.draws;
+    }
+
+    lastStats = stats;
+}
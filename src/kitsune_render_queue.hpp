@@ -0,0 +1,114 @@
+#pragma once
+#include <kitsune_types.h>
+
+static constexpr uint32_t MAX_PACKET_DESCRIPTOR_SETS = 4;
+
+// 64-bit sort key, most significant field first:
+//   [63..56] pass   [55..40] pipeline   [39..24] material   [23..0] depth
+// Sorting by key groups packets by pass, then pipeline, then material, so consecutive packets
+// share as much state as possible. Depth only orders packets that share everything else.
+namespace RenderKey
+{
+	static constexpr uint32_t DEPTH_BITS = 24;
+	static constexpr uint32_t MATERIAL_BITS = 16;
+	static constexpr uint32_t PIPELINE_BITS = 16;
+	static constexpr uint32_t PASS_BITS = 8;
+
+	static constexpr uint32_t MATERIAL_SHIFT = DEPTH_BITS;
+	static constexpr uint32_t PIPELINE_SHIFT = MATERIAL_SHIFT + MATERIAL_BITS;
+	static constexpr uint32_t PASS_SHIFT = PIPELINE_SHIFT + PIPELINE_BITS;
+
+	constexpr uint64_t Make(uint8_t pass, uint16_t pipeline, uint16_t material, uint32_t depth = 0)
+	{
+		return (uint64_t{ pass } << PASS_SHIFT) | (uint64_t{ pipeline } << PIPELINE_SHIFT) |
+			(uint64_t{ material } << MATERIAL_SHIFT) | (depth & ((1u << DEPTH_BITS) - 1));
+	}
+
+	// Quantizes a depth in [0, 1] to the key's depth field. Opaque passes sort front to back;
+	// pass `backToFront` for blended passes.
+	uint32_t Depth(float normalizedDepth, bool backToFront = false);
+
+	constexpr uint8_t GetPass(uint64_t key) { return static_cast<uint8_t>(key >> PASS_SHIFT); }
+	constexpr uint16_t GetPipeline(uint64_t key) { return static_cast<uint16_t>(key >> PIPELINE_SHIFT); }
+	constexpr uint16_t GetMaterial(uint64_t key) { return static_cast<uint16_t>(key >> MATERIAL_SHIFT); }
+}
+
+// Everything needed to record one draw. Handles are not owned; they must stay alive until
+// the command buffer the queue was recorded into has completed.
+struct DrawPacket
+{
+	uint64_t key{ 0 };
+
+	vk::Pipeline pipeline{};
+	vk::PipelineLayout layout{};
+	std::array<vk::DescriptorSet, MAX_PACKET_DESCRIPTOR_SETS> descriptorSets{};
+	uint32_t descriptorSetCount{ 0 };
+
+	vk::CullModeFlags cullMode{ vk::CullModeFlagBits::eNone };
+	vk::FrontFace frontFace{ vk::FrontFace::eCounterClockwise };
+	vk::PrimitiveTopology topology{ vk::PrimitiveTopology::eTriangleList };
+
+	vk::Buffer vertexBuffer{};
+	vk::DeviceSize vertexBufferOffset{ 0 };
+	// Indexed draw when set.
+	vk::Buffer indexBuffer{};
+	vk::DeviceSize indexBufferOffset{ 0 };
+	vk::IndexType indexType{ vk::IndexType::eUint32 };
+
+	uint32_t count{ 0 };  // vertices, or indices for indexed draws
+	uint32_t instanceCount{ 1 };
+	uint32_t first{ 0 };  // first vertex, or first index for indexed draws
+	int32_t vertexOffset{ 0 };
+	uint32_t firstInstance{ 0 };
+};
+
+struct RenderSortEntry
+{
+	uint64_t key{ 0 };
+	uint32_t index{ 0 };
+};
+
+// Stable LSD radix sort on the 64-bit key, one byte per pass. Passes where every key has the
+// same byte are skipped, so keys that only differ in a few fields sort in a few passes.
+void RadixSort(std::vector<RenderSortEntry>& entries, std::vector<RenderSortEntry>& scratch);
+
+struct RenderQueueStats
+{
+	uint32_t draws{ 0 };
+	uint32_t pipelineBinds{ 0 };
+	uint32_t descriptorSetBinds{ 0 };
+	uint32_t bufferBinds{ 0 };
+	uint32_t dynamicStateChanges{ 0 };
+	// State changes a naive per-draw recorder would have issued but were already bound.
+	uint32_t redundantSkipped{ 0 };
+};
+
+// Collects draw packets, sorts them by key and records them while skipping state that is
+// already bound from the previous packet. Packets persist until Clear(), so a static scene is
+// submitted once and recorded every frame (or replayed from KitsuneCommandCache).
+class KitsuneRenderQueue
+{
+public:
+	void Clear();
+	void Submit(const DrawPacket& packet);
+	void Sort();
+
+	// Records every packet in key order. Call between beginRendering and endRendering.
+	// Viewport and scissor are set once; bound state is tracked within this call only.
+	void Record(const vk::raii::CommandBuffer& cmd, const vk::Viewport& viewport, const vk::Rect2D& scissor);
+
+	size_t GetPacketCount() const { return packets.size(); }
+	bool IsEmpty() const { return packets.empty(); }
+	// Changes whenever the packet list changes; use it to invalidate anything recorded from the queue.
+	uint64_t GetGeneration() const { return generation; }
+	const RenderQueueStats& GetLastStats() const { return lastStats; }
+
+private:
+	std::vector<DrawPacket> packets;
+	std::vector<RenderSortEntry> sortedEntries;
+	std::vector<RenderSortEntry> scratchEntries;
+	bool isSorted{ true };
+	uint64_t generation{ 0 };
+
+	RenderQueueStats lastStats{};
+};
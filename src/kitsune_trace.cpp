@@ -0,0 +1,128 @@
+#include <kitsune_trace.hpp>
+
+#include <filesystem>
+
+namespace {
+
+void AppendJsonString(std::string& out, std::string_view text)
+{
+    out.push_back('"');
+    for (char c : text) {
+        switch (c) {
+        case '"': out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        case '\t': out += "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) out += fmt::format("\\u{:04x}", static_cast<int>(c));
+            else out.push_back(c);
+        }
+    }
+    out.push_back('"');
+}
+
+} // namespace
+
+std::shared_ptr<TraceThreadBuffer> KitsuneTrace::RegisterBuffer(std::string name)
+{
+    auto buffer = std::make_shared<TraceThreadBuffer>();
+
+    std::lock_guard lock(registryMutex);
+    buffer->threadId = nextThreadId++;
+    buffer->threadName = name.empty() ? fmt::format("Thread {}", buffer->threadId) : std::move(name);
+    buffers.push_back(buffer);
+    return buffer;
+}
+
+TraceThreadBuffer& KitsuneTrace::GetThreadBuffer()
+{
+    // Registration takes the lock once per thread; every later zone is lock-free.
+    // The registry keeps the buffer alive after the thread exits so it can still be exported.
+    thread_local std::shared_ptr<TraceThreadBuffer> buffer = RegisterBuffer({});
+    return *buffer;
+}
+
+void KitsuneTrace::SetThreadName(const char* name)
+{
+    TraceThreadBuffer& buffer = GetThreadBuffer();
+    std::lock_guard lock(registryMutex);
+    buffer.threadName = name;
+}
+
+void KitsuneTrace::RecordGpu(const char* name, uint64_t beginNs, uint64_t endNs)
+{
+    static std::shared_ptr<TraceThreadBuffer> gpuBuffer = RegisterBuffer("GPU");
+    gpuBuffer->Push({ name, beginNs, endNs });
+}
+
+bool KitsuneTrace::ExportChromeTrace(const std::string& path)
+{
+    std::vector<std::shared_ptr<TraceThreadBuffer>> snapshot;
+    {
+        std::lock_guard lock(registryMutex);
+        snapshot = buffers;
+    }
+
+    struct ExportEvent
+    {
+        uint32_t threadId;
+        TraceEvent event;
+    };
+
+    std::vector<ExportEvent> events;
+    uint64_t originNs = std::numeric_limits<uint64_t>::max();
+    for (const auto& buffer : snapshot) {
+        const uint64_t end = buffer->writeIndex.load(std::memory_order_acquire);
+        const uint64_t begin = end > TRACE_EVENTS_PER_THREAD ? end - TRACE_EVENTS_PER_THREAD : 0;
+        for (uint64_t i = begin; i < end; ++i) {
+            // The producer keeps running; slots it reuses mid-export are dropped, never torn.
+            TraceEvent event{};
+            if (!buffer->TryRead(i, event)) continue;
+            if (!event.name || event.endNs < event.beginNs) continue;
+            events.push_back({ buffer->threadId, event });
+            originNs = std::min(originNs, event.beginNs);
+        }
+    }
+
+    std::sort(events.begin(), events.end(),
+        [](const ExportEvent& a, const ExportEvent& b) { return a.event.beginNs < b.event.beginNs; });
+
+    std::string json;
+    json.reserve(events.size() * 96 + 256);
+    json += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+    bool first = true;
+    for (const auto& buffer : snapshot) {
+        std::string threadName;
+        {
+            std::lock_guard lock(registryMutex);
+            threadName = buffer->threadName;
+        }
+        if (!first) json += ",\n";
+        first = false;
+        json += fmt::format("{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},\"args\":{{\"name\":", buffer->threadId);
+        AppendJsonString(json, threadName);
+        json += "}}";
+    }
+
+    for (const auto& [threadId, event] : events) {
+        if (!first) json += ",\n";
+        first = false;
+        json += "{\"name\":";
+        AppendJsonString(json, event.name);
+        json += fmt::format(",\"ph\":\"X\",\"pid\":1,\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}}}",
+            threadId, (event.beginNs - originNs) / 1000.0, (event.endNs - event.beginNs) / 1000.0);
+    }
+    json += "\n]}\n";
+
+    std::filesystem::path outputPath(path);
+    if (outputPath.has_parent_path()) {
+        std::filesystem::create_directories(outputPath.parent_path());
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) return false;
+    file.write(json.data(), static_cast<std::streamsize>(json.size()));
+    fmt::println("Trace exported: {} ({} events)", path, events.size());
+    return static_cast<bool>(file);
+}
@@ -0,0 +1,117 @@
+#pragma once
+#include <kitsune_types.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
+// Scoped tracing zones. Names must be string literals (or otherwise outlive the trace),
+// they are stored by pointer. Build with KITSUNE_ENABLE_TRACE undefined to compile every
+// macro below out entirely.
+#if defined(KITSUNE_ENABLE_TRACE)
+#define KITSUNE_TRACE_CONCAT_INNER(a, b) a##b
+#define KITSUNE_TRACE_CONCAT(a, b) KITSUNE_TRACE_CONCAT_INNER(a, b)
+#define KITSUNE_TRACE_ZONE(name) KitsuneTraceZone KITSUNE_TRACE_CONCAT(kitsuneTraceZone_, __LINE__){ name }
+#define KITSUNE_TRACE_FUNCTION() KITSUNE_TRACE_ZONE(__func__)
+#define KITSUNE_TRACE_THREAD_NAME(name) KitsuneTrace::SetThreadName(name)
+#else
+#define KITSUNE_TRACE_ZONE(name) ((void)0)
+#define KITSUNE_TRACE_FUNCTION() ((void)0)
+#define KITSUNE_TRACE_THREAD_NAME(name) ((void)0)
+#endif
+
+static constexpr uint32_t TRACE_EVENTS_PER_THREAD = 1u << 16;
+
+struct TraceEvent
+{
+	const char* name{ nullptr };
+	uint64_t beginNs{ 0 };
+	uint64_t endNs{ 0 };
+};
+
+// One ring entry, guarded by a per-slot sequence lock. The sequence is 2 * index + 1 while
+// event `index` is being written and 2 * index + 2 once it is complete, so a reader can tell
+// both a torn slot and a slot that has already been reused for a later event.
+struct TraceSlot
+{
+	std::atomic<uint64_t> sequence{ 0 };
+	std::atomic<const char*> name{ nullptr };
+	std::atomic<uint64_t> beginNs{ 0 };
+	std::atomic<uint64_t> endNs{ 0 };
+};
+
+// Fixed-size ring owned by one producer thread. The producer never blocks or locks;
+// the exporter reads a snapshot and skips entries that are overwritten while it reads them.
+struct TraceThreadBuffer
+{
+	uint32_t threadId{ 0 };
+	std::string threadName;
+	std::unique_ptr<TraceSlot[]> events{ std::make_unique<TraceSlot[]>(TRACE_EVENTS_PER_THREAD) };
+	std::atomic<uint64_t> writeIndex{ 0 };
+
+	void Push(const TraceEvent& event)
+	{
+		uint64_t index = writeIndex.load(std::memory_order_relaxed);
+		TraceSlot& slot = events[index & (TRACE_EVENTS_PER_THREAD - 1)];
+		slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		slot.name.store(event.name, std::memory_order_relaxed);
+		slot.beginNs.store(event.beginNs, std::memory_order_relaxed);
+		slot.endNs.store(event.endNs, std::memory_order_relaxed);
+		slot.sequence.store(2 * index + 2, std::memory_order_release);
+		writeIndex.store(index + 1, std::memory_order_release);
+	}
+
+	// Copies event `index` if it is complete and was not overwritten during the copy.
+	bool TryRead(uint64_t index, TraceEvent& out) const
+	{
+		const TraceSlot& slot = events[index & (TRACE_EVENTS_PER_THREAD - 1)];
+		const uint64_t expected = 2 * index + 2;
+		if (slot.sequence.load(std::memory_order_acquire) != expected) return false;
+		out.name = slot.name.load(std::memory_order_relaxed);
+		out.beginNs = slot.beginNs.load(std::memory_order_relaxed);
+		out.endNs = slot.endNs.load(std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_acquire);
+		return slot.sequence.load(std::memory_order_relaxed) == expected;
+	}
+};
+
+class KitsuneTrace
+{
+public:
+	// Trace timestamps are std::chrono::steady_clock nanoseconds.
+	static uint64_t Now()
+	{
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+
+	static void SetThreadName(const char* name);
+	static void Record(const char* name, uint64_t beginNs, uint64_t endNs) { GetThreadBuffer().Push({ name, beginNs, endNs }); }
+	// GPU zones land on their own track. Timestamps must already be in the trace clock domain.
+	static void RecordGpu(const char* name, uint64_t beginNs, uint64_t endNs);
+
+	static bool ExportChromeTrace(const std::string& path);
+
+private:
+	static TraceThreadBuffer& GetThreadBuffer();
+	static std::shared_ptr<TraceThreadBuffer> RegisterBuffer(std::string name);
+
+	static inline std::mutex registryMutex;
+	static inline std::vector<std::shared_ptr<TraceThreadBuffer>> buffers;
+	static inline uint32_t nextThreadId{ 1 };
+};
+
+class KitsuneTraceZone
+{
+public:
+	explicit KitsuneTraceZone(const char* name) : name_(name), beginNs_(KitsuneTrace::Now()) {}
+	~KitsuneTraceZone() { KitsuneTrace::Record(name_, beginNs_, KitsuneTrace::Now()); }
+
+	KitsuneTraceZone(const KitsuneTraceZone&) = delete;
+	KitsuneTraceZone& operator=(const KitsuneTraceZone&) = delete;
+
+private:
+	const char* name_;
+	uint64_t beginNs_;
+};
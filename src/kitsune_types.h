@@ -49,4 +49,5 @@
 static constexpr const char* ENGINE_NAME = "HelloTriangle";
 static constexpr uint32_t ENGINE_VERSION = VK_MAKE_VERSION(1, 0, 0);
 static constexpr uint32_t API_VERSION = VK_API_VERSION_1_3;
-static constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 2;
\ No newline at end of file
+static constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 2;
+static constexpr uint32_t READBACK_RING_SIZE = MAX_FRAMES_IN_FLIGHT + 2;
\ No newline at end of file
@@ -15,14 +15,29 @@ void KitsuneWindowing::init()
     SDL_GetDisplayUsableBounds(primary, &usableBounds);
     fmt::println("Display usable bounds: {}x{}", usableBounds.w, usableBounds.h);
 
-    window.reset(SDL_CreateWindow(
-        ENGINE_NAME,
-        usableBounds.w - 4, usableBounds.h - 34, // Account for title bar and resize handle
-        SDL_WINDOW_VULKAN | SDL_WINDOW_RESIZABLE | SDL_WINDOW_HIDDEN));
+    uint32_t index = AddWindow(ENGINE_NAME,
+        usableBounds.w - 4, usableBounds.h - 34); // Account for title bar and resize handle
+    SDL_SetWindowPosition(windows[index].get(), 2, 32);
+}
+
+uint32_t KitsuneWindowing::AddWindow(const std::string& title, int width, int height)
+{
+    std::unique_ptr<SDL_Window, decltype(&SDL_DestroyWindow)> window{
+        SDL_CreateWindow(title.c_str(), width, height, SDL_WINDOW_VULKAN | SDL_WINDOW_RESIZABLE | SDL_WINDOW_HIDDEN),
+        SDL_DestroyWindow };
     if (!window) throw SDLException("Failed to create window");
 
     SDL_SetWindowMinimumSize(window.get(), 100, 100);
-    SDL_SetWindowPosition(window.get(), 2, 32);
+    windows.push_back(std::move(window));
+    return static_cast<uint32_t>(windows.size() - 1);
+}
+
+std::optional<uint32_t> KitsuneWindowing::GetWindowIndex(SDL_WindowID windowId) const
+{
+    for (uint32_t i = 0; i < windows.size(); ++i) {
+        if (SDL_GetWindowID(windows[i].get()) == windowId) return i;
+    }
+    return std::nullopt;
 }
 
 void KitsuneWindowing::GetInstanceExtensions(std::vector<const char*>& extensions) const
@@ -36,16 +51,32 @@ void KitsuneWindowing::GetInstanceExtensions(std::vector<const char*>& extension
     }
 }
 
-vk::Extent2D KitsuneWindowing::GetWindowExtent() const {
+vk::Extent2D KitsuneWindowing::GetWindowExtent(uint32_t index) const {
     int w, h;
-    SDL_GetWindowSizeInPixels(window.get(), &w, &h);
+    SDL_GetWindowSizeInPixels(windows[index].get(), &w, &h);
     return { static_cast<uint32_t>(w), static_cast<uint32_t>(h) };
 }
 
-VkSurfaceKHR KitsuneWindowing::GetSurface(const vk::raii::Instance& vkInstance) const
+vk::Extent2D KitsuneWindowing::GetMaxDisplayExtent() const {
+    vk::Extent2D extent{ 0, 0 };
+    int count = 0;
+    SDL_DisplayID* displays = SDL_GetDisplays(&count);
+    if (!displays) return extent;
+
+    for (int i = 0; i < count; ++i) {
+        const SDL_DisplayMode* mode = SDL_GetDesktopDisplayMode(displays[i]);
+        if (!mode) continue;
+        extent.width = std::max(extent.width, static_cast<uint32_t>(mode->w * mode->pixel_density));
+        extent.height = std::max(extent.height, static_cast<uint32_t>(mode->h * mode->pixel_density));
+    }
+    SDL_free(displays);
+    return extent;
+}
+
+VkSurfaceKHR KitsuneWindowing::GetSurface(const vk::raii::Instance& vkInstance, uint32_t index) const
 {
     VkSurfaceKHR surface;
-    if (!SDL_Vulkan_CreateSurface(window.get(), *vkInstance, nullptr, &surface))
+    if (!SDL_Vulkan_CreateSurface(windows[index].get(), *vkInstance, nullptr, &surface))
     {
         throw SDLException("Failed to create surface");
     }
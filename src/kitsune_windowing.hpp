@@ -7,21 +7,31 @@ public:
 	KitsuneWindowing();
 	~KitsuneWindowing();
 
+	// Creates the primary window (index 0).
 	void init();
-	void ShowWindow() { SDL_ShowWindow(window.get()); }
-	void MaximizeWindow() { SDL_MaximizeWindow(window.get()); }
-	void MinimizeWindow() { SDL_MinimizeWindow(window.get()); }
+	// Creates an additional window and returns its index.
+	uint32_t AddWindow(const std::string& title, int width, int height);
+
+	uint32_t GetWindowCount() const { return static_cast<uint32_t>(windows.size()); }
+	std::optional<uint32_t> GetWindowIndex(SDL_WindowID windowId) const;
+
+	void ShowWindow(uint32_t index = 0) { SDL_ShowWindow(windows[index].get()); }
+	void HideWindow(uint32_t index = 0) { SDL_HideWindow(windows[index].get()); }
+	void MaximizeWindow(uint32_t index = 0) { SDL_MaximizeWindow(windows[index].get()); }
+	void MinimizeWindow(uint32_t index = 0) { SDL_MinimizeWindow(windows[index].get()); }
 
 	PFN_vkGetInstanceProcAddr GetVkGetInstanceProcAddr() const;
 
 	void GetInstanceExtensions(std::vector<const char*>& extensions) const;
 
-	VkSurfaceKHR GetSurface(const vk::raii::Instance& vkInstance) const;
+	VkSurfaceKHR GetSurface(const vk::raii::Instance& vkInstance, uint32_t index = 0) const;
 
-	vk::Extent2D GetWindowExtent() const;
+	vk::Extent2D GetWindowExtent(uint32_t index = 0) const;
+	// Largest desktop resolution in pixels across all connected displays.
+	vk::Extent2D GetMaxDisplayExtent() const;
 
 private:
-	std::unique_ptr<SDL_Window, decltype(&SDL_DestroyWindow)> window{ nullptr, SDL_DestroyWindow };
+	std::vector<std::unique_ptr<SDL_Window, decltype(&SDL_DestroyWindow)>> windows;
 
 };
 
@@ -0,0 +1,166 @@
+// kitsune_cook: offline mesh cooker.
+//
+//   kitsune_cook [--force] [--output <dir>] <file.obj | directory>...
+//
+// Each source mesh is vertex cache optimized, reordered for vertex fetch, split into
+// meshlets, quantized and written as <name>.kmesh. Packages whose recorded source hash
+// matches the current input are skipped, so re-running over a content tree only cooks
+// what changed.
+#include <kitsune_cook_mesh.hpp>
+
+#include <fmt/core.h>
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Bump whenever cooked output changes for the same input.
+constexpr uint32_t COOKER_VERSION = 1;
+constexpr uint32_t VERTEX_CACHE_ANALYZE_SIZE = 32;
+
+struct CookOptions
+{
+    fs::path outputDirectory;
+    bool force{ false };
+};
+
+uint64_t HashBytes(uint64_t hash, const void* data, size_t size)
+{
+    // FNV-1a
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 0x100000001B3ull;
+    }
+    return hash;
+}
+
+std::optional<uint64_t> HashSource(const fs::path& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) return std::nullopt;
+
+    std::vector<char> contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    uint64_t hash = 0xCBF29CE484222325ull;
+    const uint32_t settings[] = { COOKER_VERSION, MESH_PACKAGE_VERSION, MESHLET_MAX_VERTICES, MESHLET_MAX_TRIANGLES };
+    hash = HashBytes(hash, settings, sizeof(settings));
+    return HashBytes(hash, contents.data(), contents.size());
+}
+
+enum class CookResult { Cooked, UpToDate, Failed };
+
+CookResult CookMesh(const fs::path& source, const CookOptions& options)
+{
+    fs::path outputDirectory = options.outputDirectory.empty() ? source.parent_path() : options.outputDirectory;
+    fs::path output = outputDirectory / source.filename().replace_extension(".kmesh");
+
+    auto sourceHash = HashSource(source);
+    if (!sourceHash) {
+        fmt::println("[kitsune_cook] {}: cannot read source", source.string());
+        return CookResult::Failed;
+    }
+
+    if (!options.force) {
+        auto existing = ReadMeshPackageHeader(output.string());
+        if (existing && existing->sourceHash == *sourceHash) return CookResult::UpToDate;
+    }
+
+    std::string error;
+    auto mesh = LoadObjMesh(source.string(), error);
+    if (!mesh) {
+        fmt::println("[kitsune_cook] {}: {}", source.string(), error);
+        return CookResult::Failed;
+    }
+
+    const double acmrBefore = AnalyzeVertexCache(mesh->indices, VERTEX_CACHE_ANALYZE_SIZE);
+    OptimizeVertexCache(mesh->indices, mesh->vertices.size());
+    OptimizeVertexFetch(mesh->vertices, mesh->indices);
+    const double acmrAfter = AnalyzeVertexCache(mesh->indices, VERTEX_CACHE_ANALYZE_SIZE);
+
+    CookedMesh cooked;
+    cooked.header.sourceHash = *sourceHash;
+    cooked.meshlets = BuildMeshlets(mesh->vertices, mesh->indices);
+    cooked.vertices = QuantizeVertices(mesh->vertices, cooked.header.boundsMin, cooked.header.boundsMax);
+    cooked.indices = std::move(mesh->indices);
+
+    std::error_code ec;
+    fs::create_directories(outputDirectory, ec);
+    if (!WriteMeshPackage(output.string(), cooked)) {
+        fmt::println("[kitsune_cook] {}: failed to write {}", source.string(), output.string());
+        return CookResult::Failed;
+    }
+
+    fmt::println("[kitsune_cook] {} -> {}: {} vertices, {} triangles, {} meshlets, ACMR {:.3f} -> {:.3f}",
+        source.string(), output.string(), cooked.vertices.size(), cooked.indices.size() / 3,
+        cooked.meshlets.meshlets.size(), acmrBefore, acmrAfter);
+    return CookResult::Cooked;
+}
+
+bool IsMeshSource(const fs::path& path)
+{
+    std::string extension = path.extension().string();
+    for (char& c : extension) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    return extension == ".obj";
+}
+
+void PrintUsage()
+{
+    fmt::println("usage: kitsune_cook [--force] [--output <dir>] <file.obj | directory>...");
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    CookOptions options;
+    std::vector<fs::path> sources;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--force") {
+            options.force = true;
+        }
+        else if (arg == "--output" && i + 1 < argc) {
+            options.outputDirectory = argv[++i];
+        }
+        else if (arg == "--help" || arg == "-h") {
+            PrintUsage();
+            return EXIT_SUCCESS;
+        }
+        else if (fs::is_directory(arg)) {
+            for (const auto& entry : fs::recursive_directory_iterator(arg)) {
+                if (entry.is_regular_file() && IsMeshSource(entry.path())) sources.push_back(entry.path());
+            }
+        }
+        else if (fs::is_regular_file(arg)) {
+            sources.push_back(arg);
+        }
+        else {
+            fmt::println("[kitsune_cook] unknown argument or missing input: {}", arg);
+            PrintUsage();
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (sources.empty()) {
+        PrintUsage();
+        return EXIT_FAILURE;
+    }
+
+    uint32_t cooked = 0, upToDate = 0, failed = 0;
+    for (const auto& source : sources) {
+        switch (CookMesh(source, options)) {
+        case CookResult::Cooked: ++cooked; break;
+        case CookResult::UpToDate: ++upToDate; break;
+        case CookResult::Failed: ++failed; break;
+        }
+    }
+
+    fmt::println("[kitsune_cook] {} cooked, {} up to date, {} failed", cooked, upToDate, failed);
+    return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
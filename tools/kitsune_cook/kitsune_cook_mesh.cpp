@@ -0,0 +1,646 @@
+#include <kitsune_cook_mesh.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+
+namespace {
+
+struct ObjCorner
+{
+    int position{ -1 };
+    int uv{ -1 };
+    int normal{ -1 };
+
+    bool operator==(const ObjCorner& other) const
+    {
+        return position == other.position && uv == other.uv && normal == other.normal;
+    }
+};
+
+struct ObjCornerHash
+{
+    size_t operator()(const ObjCorner& corner) const
+    {
+        size_t hash = static_cast<size_t>(corner.position) * 73856093u;
+        hash ^= static_cast<size_t>(corner.uv + 1) * 19349663u;
+        hash ^= static_cast<size_t>(corner.normal + 1) * 83492791u;
+        return hash;
+    }
+};
+
+// OBJ indices are 1-based, negative values count back from the end.
+int ResolveObjIndex(int index, size_t count)
+{
+    if (index > 0) return index - 1;
+    if (index < 0) return static_cast<int>(count) + index;
+    return -1;
+}
+
+bool ParseObjCorner(const std::string& token, size_t positionCount, size_t uvCount, size_t normalCount, ObjCorner& corner)
+{
+    // uv and normal may be omitted ("v", "v//vn"); any index that is given must be non-zero and in range.
+    int values[3] = { 0, 0, 0 };
+    bool present[3] = { false, false, false };
+    size_t start = 0;
+    for (int component = 0; component < 3 && start <= token.size(); ++component) {
+        size_t end = token.find('/', start);
+        std::string part = token.substr(start, end == std::string::npos ? std::string::npos : end - start);
+        if (!part.empty()) {
+            values[component] = std::atoi(part.c_str());
+            present[component] = true;
+        }
+        if (end == std::string::npos) break;
+        start = end + 1;
+    }
+    if (!present[0]) return false;
+
+    const size_t counts[3] = { positionCount, uvCount, normalCount };
+    int resolved[3] = { -1, -1, -1 };
+    for (int component = 0; component < 3; ++component) {
+        if (!present[component]) continue;
+        if (values[component] == 0) return false;
+        resolved[component] = ResolveObjIndex(values[component], counts[component]);
+        if (resolved[component] < 0 || resolved[component] >= static_cast<int>(counts[component])) return false;
+    }
+
+    corner.position = resolved[0];
+    corner.uv = resolved[1];
+    corner.normal = resolved[2];
+    return true;
+}
+
+void Subtract(const float a[3], const float b[3], float out[3])
+{
+    out[0] = a[0] - b[0];
+    out[1] = a[1] - b[1];
+    out[2] = a[2] - b[2];
+}
+
+void Cross(const float a[3], const float b[3], float out[3])
+{
+    out[0] = a[1] * b[2] - a[2] * b[1];
+    out[1] = a[2] * b[0] - a[0] * b[2];
+    out[2] = a[0] * b[1] - a[1] * b[0];
+}
+
+float Dot(const float a[3], const float b[3])
+{
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+float Normalize(float v[3])
+{
+    float length = std::sqrt(Dot(v, v));
+    if (length > 0.0f) {
+        v[0] /= length;
+        v[1] /= length;
+        v[2] /= length;
+    }
+    return length;
+}
+
+void GenerateNormals(SourceMesh& mesh)
+{
+    for (auto& vertex : mesh.vertices) {
+        vertex.normal[0] = vertex.normal[1] = vertex.normal[2] = 0.0f;
+    }
+
+    // Area-weighted face normals, accumulated per merged vertex.
+    for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3) {
+        SourceVertex& a = mesh.vertices[mesh.indices[i]];
+        SourceVertex& b = mesh.vertices[mesh.indices[i + 1]];
+        SourceVertex& c = mesh.vertices[mesh.indices[i + 2]];
+        float ab[3], ac[3], normal[3];
+        Subtract(b.position, a.position, ab);
+        Subtract(c.position, a.position, ac);
+        Cross(ab, ac, normal);
+        for (SourceVertex* vertex : { &a, &b, &c }) {
+            vertex->normal[0] += normal[0];
+            vertex->normal[1] += normal[1];
+            vertex->normal[2] += normal[2];
+        }
+    }
+
+    for (auto& vertex : mesh.vertices) {
+        if (Normalize(vertex.normal) == 0.0f) vertex.normal[2] = 1.0f;
+    }
+}
+
+// Forsyth vertex cache optimization tuning, see "Linear-Speed Vertex Cache Optimisation".
+constexpr uint32_t FORSYTH_CACHE_SIZE = 32;
+constexpr float FORSYTH_CACHE_DECAY_POWER = 1.5f;
+constexpr float FORSYTH_LAST_TRIANGLE_SCORE = 0.75f;
+constexpr float FORSYTH_VALENCE_BOOST_SCALE = 2.0f;
+constexpr float FORSYTH_VALENCE_BOOST_POWER = 0.5f;
+
+float ForsythVertexScore(int cachePosition, uint32_t remainingTriangles)
+{
+    if (remainingTriangles == 0) return -1.0f;
+
+    float score = 0.0f;
+    if (cachePosition >= 0) {
+        if (cachePosition < 3) {
+            score = FORSYTH_LAST_TRIANGLE_SCORE;
+        }
+        else {
+            const float scaler = 1.0f / (FORSYTH_CACHE_SIZE - 3);
+            score = std::pow(1.0f - (cachePosition - 3) * scaler, FORSYTH_CACHE_DECAY_POWER);
+        }
+    }
+    score += FORSYTH_VALENCE_BOOST_SCALE * std::pow(static_cast<float>(remainingTriangles), -FORSYTH_VALENCE_BOOST_POWER);
+    return score;
+}
+
+uint16_t EncodeSnorm16(float value)
+{
+    float clamped = std::clamp(value, -1.0f, 1.0f);
+    return static_cast<uint16_t>(static_cast<int16_t>(std::lround(clamped * 32767.0f)));
+}
+
+template <typename T>
+void WriteSection(std::ofstream& file, uint64_t offset, const std::vector<T>& data)
+{
+    file.seekp(static_cast<std::streamoff>(offset));
+    file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size() * sizeof(T)));
+}
+
+uint64_t AlignOffset(uint64_t offset)
+{
+    return (offset + 15) & ~uint64_t{ 15 };
+}
+
+} // namespace
+
+std::optional<SourceMesh> LoadObjMesh(const std::string& path, std::string& error)
+{
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        error = "cannot open file";
+        return std::nullopt;
+    }
+
+    std::vector<std::array<float, 3>> positions;
+    std::vector<std::array<float, 2>> uvs;
+    std::vector<std::array<float, 3>> normals;
+
+    SourceMesh mesh;
+    std::unordered_map<ObjCorner, uint32_t, ObjCornerHash> cornerToVertex;
+    bool hasMissingNormals = false;
+
+    std::string line;
+    std::vector<uint32_t> polygon;
+    size_t lineNumber = 0;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        std::istringstream stream(line);
+        std::string keyword;
+        stream >> keyword;
+
+        if (keyword == "v") {
+            std::array<float, 3> p{};
+            stream >> p[0] >> p[1] >> p[2];
+            positions.push_back(p);
+        }
+        else if (keyword == "vt") {
+            std::array<float, 2> t{};
+            stream >> t[0] >> t[1];
+            uvs.push_back(t);
+        }
+        else if (keyword == "vn") {
+            std::array<float, 3> n{};
+            stream >> n[0] >> n[1] >> n[2];
+            normals.push_back(n);
+        }
+        else if (keyword == "f") {
+            polygon.clear();
+            std::string token;
+            while (stream >> token) {
+                ObjCorner corner{};
+                if (!ParseObjCorner(token, positions.size(), uvs.size(), normals.size(), corner)) {
+                    error = "invalid face index on line " + std::to_string(lineNumber);
+                    return std::nullopt;
+                }
+
+                auto [it, inserted] = cornerToVertex.try_emplace(corner, static_cast<uint32_t>(mesh.vertices.size()));
+                if (inserted) {
+                    SourceVertex vertex{};
+                    std::copy_n(positions[corner.position].data(), 3, vertex.position);
+                    if (corner.uv >= 0) {
+                        vertex.uv[0] = uvs[corner.uv][0];
+                        vertex.uv[1] = 1.0f - uvs[corner.uv][1]; // OBJ uvs are bottom-up
+                    }
+                    if (corner.normal >= 0) {
+                        std::copy_n(normals[corner.normal].data(), 3, vertex.normal);
+                        Normalize(vertex.normal);
+                    }
+                    else {
+                        hasMissingNormals = true;
+                    }
+                    mesh.vertices.push_back(vertex);
+                }
+                polygon.push_back(it->second);
+            }
+
+            for (size_t i = 1; i + 1 < polygon.size(); ++i) {
+                mesh.indices.push_back(polygon[0]);
+                mesh.indices.push_back(polygon[i]);
+                mesh.indices.push_back(polygon[i + 1]);
+            }
+        }
+    }
+
+    if (mesh.indices.empty()) {
+        error = "no triangles";
+        return std::nullopt;
+    }
+
+    if (hasMissingNormals) GenerateNormals(mesh);
+    return mesh;
+}
+
+void OptimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount)
+{
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0) return;
+
+    // Vertex -> triangle adjacency in compressed rows.
+    std::vector<uint32_t> remaining(vertexCount, 0);
+    for (uint32_t index : indices) ++remaining[index];
+
+    std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; ++v) adjacencyOffsets[v + 1] = adjacencyOffsets[v] + remaining[v];
+    std::vector<uint32_t> adjacency(indices.size());
+    std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+    for (size_t t = 0; t < triangleCount; ++t) {
+        for (size_t c = 0; c < 3; ++c) {
+            adjacency[fill[indices[t * 3 + c]]++] = static_cast<uint32_t>(t);
+        }
+    }
+
+    std::vector<int> cachePosition(vertexCount, -1);
+    std::vector<float> vertexScore(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v) vertexScore[v] = ForsythVertexScore(-1, remaining[v]);
+
+    std::vector<float> triangleScore(triangleCount);
+    for (size_t t = 0; t < triangleCount; ++t) {
+        triangleScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+    }
+
+    std::vector<bool> emitted(triangleCount, false);
+    std::vector<uint32_t> output;
+    output.reserve(indices.size());
+
+    std::vector<uint32_t> cache;
+    std::vector<uint32_t> newCache;
+    cache.reserve(FORSYTH_CACHE_SIZE + 3);
+    newCache.reserve(FORSYTH_CACHE_SIZE + 3);
+
+    size_t fallbackCursor = 0;
+    int64_t bestTriangle = -1;
+
+    for (size_t emittedCount = 0; emittedCount < triangleCount; ++emittedCount) {
+        if (bestTriangle < 0) {
+            // Nothing adjacent to the cache: take the best remaining triangle overall.
+            float bestScore = -1.0f;
+            for (size_t t = fallbackCursor; t < triangleCount; ++t) {
+                if (emitted[t]) {
+                    if (t == fallbackCursor) ++fallbackCursor;
+                    continue;
+                }
+                if (triangleScore[t] > bestScore) {
+                    bestScore = triangleScore[t];
+                    bestTriangle = static_cast<int64_t>(t);
+                }
+            }
+        }
+
+        const size_t triangle = static_cast<size_t>(bestTriangle);
+        emitted[triangle] = true;
+
+        newCache.clear();
+        for (size_t c = 0; c < 3; ++c) {
+            uint32_t vertex = indices[triangle * 3 + c];
+            output.push_back(vertex);
+            newCache.push_back(vertex);
+
+            // Drop the triangle from the vertex's live adjacency.
+            uint32_t* begin = adjacency.data() + adjacencyOffsets[vertex];
+            uint32_t* end = begin + remaining[vertex];
+            uint32_t* found = std::find(begin, end, static_cast<uint32_t>(triangle));
+            if (found != end) {
+                std::swap(*found, *(end - 1));
+                --remaining[vertex];
+            }
+        }
+
+        for (uint32_t vertex : cache) {
+            if (std::find(newCache.begin(), newCache.end(), vertex) == newCache.end()) {
+                newCache.push_back(vertex);
+            }
+        }
+
+        // Vertices pushed past the cache size are evicted but still need rescoring.
+        for (size_t i = 0; i < newCache.size(); ++i) {
+            uint32_t vertex = newCache[i];
+            cachePosition[vertex] = i < FORSYTH_CACHE_SIZE ? static_cast<int>(i) : -1;
+            vertexScore[vertex] = ForsythVertexScore(cachePosition[vertex], remaining[vertex]);
+        }
+
+        bestTriangle = -1;
+        float bestScore = -1.0f;
+        for (uint32_t vertex : newCache) {
+            const uint32_t* begin = adjacency.data() + adjacencyOffsets[vertex];
+            for (uint32_t i = 0; i < remaining[vertex]; ++i) {
+                uint32_t t = begin[i];
+                float score = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+                triangleScore[t] = score;
+                if (score > bestScore) {
+                    bestScore = score;
+                    bestTriangle = t;
+                }
+            }
+        }
+
+        if (newCache.size() > FORSYTH_CACHE_SIZE) newCache.resize(FORSYTH_CACHE_SIZE);
+        std::swap(cache, newCache);
+    }
+
+    indices = std::move(output);
+}
+
+void OptimizeVertexFetch(std::vector<SourceVertex>& vertices, std::vector<uint32_t>& indices)
+{
+    constexpr uint32_t UNUSED = ~0u;
+    std::vector<uint32_t> remap(vertices.size(), UNUSED);
+    std::vector<SourceVertex> reordered;
+    reordered.reserve(vertices.size());
+
+    for (uint32_t& index : indices) {
+        if (remap[index] == UNUSED) {
+            remap[index] = static_cast<uint32_t>(reordered.size());
+            reordered.push_back(vertices[index]);
+        }
+        index = remap[index];
+    }
+
+    vertices = std::move(reordered);
+}
+
+double AnalyzeVertexCache(const std::vector<uint32_t>& indices, uint32_t cacheSize)
+{
+    if (indices.size() < 3) return 0.0;
+
+    std::vector<uint32_t> fifo(cacheSize, ~0u);
+    size_t head = 0;
+    size_t misses = 0;
+    for (uint32_t index : indices) {
+        if (std::find(fifo.begin(), fifo.end(), index) == fifo.end()) {
+            fifo[head] = index;
+            head = (head + 1) % cacheSize;
+            ++misses;
+        }
+    }
+    return static_cast<double>(misses) / static_cast<double>(indices.size() / 3);
+}
+
+MeshletData BuildMeshlets(const std::vector<SourceVertex>& vertices, const std::vector<uint32_t>& indices,
+    uint32_t maxVertices, uint32_t maxTriangles)
+{
+    MeshletData data;
+    if (indices.empty()) return data;
+
+    // Local slot of each vertex in the current meshlet, valid while stamp matches.
+    std::vector<uint8_t> localIndex(vertices.size(), 0);
+    std::vector<uint32_t> stamp(vertices.size(), ~0u);
+
+    MeshletDesc current{};
+    auto finishMeshlet = [&]() {
+        if (current.triangleCount == 0) return;
+
+        const uint32_t* meshletVertices = data.vertices.data() + current.vertexOffset;
+        const uint8_t* meshletTriangles = data.triangles.data() + current.triangleOffset * 3;
+
+        float minimum[3] = { INFINITY, INFINITY, INFINITY };
+        float maximum[3] = { -INFINITY, -INFINITY, -INFINITY };
+        for (uint32_t i = 0; i < current.vertexCount; ++i) {
+            const float* p = vertices[meshletVertices[i]].position;
+            for (int axis = 0; axis < 3; ++axis) {
+                minimum[axis] = std::min(minimum[axis], p[axis]);
+                maximum[axis] = std::max(maximum[axis], p[axis]);
+            }
+        }
+        for (int axis = 0; axis < 3; ++axis) current.center[axis] = (minimum[axis] + maximum[axis]) * 0.5f;
+        for (uint32_t i = 0; i < current.vertexCount; ++i) {
+            float offset[3];
+            Subtract(vertices[meshletVertices[i]].position, current.center, offset);
+            current.radius = std::max(current.radius, std::sqrt(Dot(offset, offset)));
+        }
+
+        // Normal cone from the triangle normals; any triangle facing more than 90 degrees
+        // away from the axis disables cone culling for the meshlet.
+        std::vector<std::array<float, 3>> triangleNormals;
+        triangleNormals.reserve(current.triangleCount);
+        float axis[3] = { 0.0f, 0.0f, 0.0f };
+        for (uint32_t t = 0; t < current.triangleCount; ++t) {
+            const float* a = vertices[meshletVertices[meshletTriangles[t * 3]]].position;
+            const float* b = vertices[meshletVertices[meshletTriangles[t * 3 + 1]]].position;
+            const float* c = vertices[meshletVertices[meshletTriangles[t * 3 + 2]]].position;
+            float ab[3], ac[3];
+            std::array<float, 3> normal{};
+            Subtract(b, a, ab);
+            Subtract(c, a, ac);
+            Cross(ab, ac, normal.data());
+            if (Normalize(normal.data()) == 0.0f) continue;
+            triangleNormals.push_back(normal);
+            axis[0] += normal[0];
+            axis[1] += normal[1];
+            axis[2] += normal[2];
+        }
+
+        current.coneCutoff = 1.0f;
+        if (Normalize(axis) > 0.0f && !triangleNormals.empty()) {
+            float minimumDot = 1.0f;
+            for (const auto& normal : triangleNormals) minimumDot = std::min(minimumDot, Dot(axis, normal.data()));
+            if (minimumDot > 0.0f) {
+                std::copy_n(axis, 3, current.coneAxis);
+                current.coneCutoff = std::sqrt(1.0f - minimumDot * minimumDot);
+            }
+        }
+
+        data.meshlets.push_back(current);
+        current = MeshletDesc{};
+        current.vertexOffset = static_cast<uint32_t>(data.vertices.size());
+        current.triangleOffset = static_cast<uint32_t>(data.triangles.size() / 3);
+    };
+
+    for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+        const uint32_t meshletId = static_cast<uint32_t>(data.meshlets.size());
+        uint32_t newVertices = 0;
+        for (size_t c = 0; c < 3; ++c) {
+            uint32_t vertex = indices[i + c];
+            bool duplicate = (c > 0 && indices[i] == vertex) || (c > 1 && indices[i + 1] == vertex);
+            if (stamp[vertex] != meshletId && !duplicate) ++newVertices;
+        }
+
+        if (current.vertexCount + newVertices > maxVertices || current.triangleCount + 1 > maxTriangles) {
+            finishMeshlet();
+        }
+
+        const uint32_t id = static_cast<uint32_t>(data.meshlets.size());
+        for (size_t c = 0; c < 3; ++c) {
+            uint32_t vertex = indices[i + c];
+            if (stamp[vertex] != id) {
+                stamp[vertex] = id;
+                localIndex[vertex] = static_cast<uint8_t>(current.vertexCount++);
+                data.vertices.push_back(vertex);
+            }
+            data.triangles.push_back(localIndex[vertex]);
+        }
+        ++current.triangleCount;
+    }
+    finishMeshlet();
+
+    return data;
+}
+
+uint16_t FloatToHalf(float value)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    const uint32_t sign = (bits >> 16) & 0x8000u;
+    const int32_t exponent = static_cast<int32_t>((bits >> 23) & 0xFFu) - 127 + 15;
+    uint32_t mantissa = bits & 0x7FFFFFu;
+
+    if (((bits >> 23) & 0xFFu) == 0xFFu) {
+        // Inf stays inf, NaN stays a quiet NaN.
+        return static_cast<uint16_t>(sign | 0x7C00u | (mantissa ? 0x200u : 0u));
+    }
+    if (exponent >= 31) {
+        return static_cast<uint16_t>(sign | 0x7C00u);
+    }
+    if (exponent <= 0) {
+        if (exponent < -10) return static_cast<uint16_t>(sign);
+        // Denormal: shift in the implicit bit and round to nearest even.
+        mantissa |= 0x800000u;
+        const uint32_t shift = static_cast<uint32_t>(14 - exponent);
+        uint32_t half = mantissa >> shift;
+        const uint32_t remainder = mantissa & ((1u << shift) - 1);
+        const uint32_t halfway = 1u << (shift - 1);
+        if (remainder > halfway || (remainder == halfway && (half & 1u))) ++half;
+        return static_cast<uint16_t>(sign | half);
+    }
+
+    uint32_t half = sign | (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13);
+    const uint32_t remainder = mantissa & 0x1FFFu;
+    // Round to nearest even; a carry into the exponent correctly rounds up to the next power of two (or inf).
+    if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u))) ++half;
+    return static_cast<uint16_t>(half);
+}
+
+std::vector<PackedVertex> QuantizeVertices(const std::vector<SourceVertex>& vertices, float boundsMin[3], float boundsMax[3])
+{
+    for (int axis = 0; axis < 3; ++axis) {
+        boundsMin[axis] = INFINITY;
+        boundsMax[axis] = -INFINITY;
+    }
+    for (const auto& vertex : vertices) {
+        for (int axis = 0; axis < 3; ++axis) {
+            boundsMin[axis] = std::min(boundsMin[axis], vertex.position[axis]);
+            boundsMax[axis] = std::max(boundsMax[axis], vertex.position[axis]);
+        }
+    }
+
+    std::vector<PackedVertex> packed(vertices.size());
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        const SourceVertex& source = vertices[i];
+        PackedVertex& target = packed[i];
+
+        for (int axis = 0; axis < 3; ++axis) {
+            const float extent = boundsMax[axis] - boundsMin[axis];
+            const float normalized = extent > 0.0f ? (source.position[axis] - boundsMin[axis]) / extent : 0.0f;
+            target.position[axis] = static_cast<uint16_t>(std::lround(std::clamp(normalized, 0.0f, 1.0f) * 65535.0f));
+        }
+
+        // Octahedral mapping keeps unit normals accurate in two components.
+        float n[3] = { source.normal[0], source.normal[1], source.normal[2] };
+        const float sum = std::abs(n[0]) + std::abs(n[1]) + std::abs(n[2]);
+        float x = sum > 0.0f ? n[0] / sum : 0.0f;
+        float y = sum > 0.0f ? n[1] / sum : 0.0f;
+        if (n[2] < 0.0f) {
+            const float foldedX = (1.0f - std::abs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+            const float foldedY = (1.0f - std::abs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+            x = foldedX;
+            y = foldedY;
+        }
+        target.normal[0] = static_cast<int16_t>(EncodeSnorm16(x));
+        target.normal[1] = static_cast<int16_t>(EncodeSnorm16(y));
+
+        target.uv[0] = FloatToHalf(source.uv[0]);
+        target.uv[1] = FloatToHalf(source.uv[1]);
+    }
+    return packed;
+}
+
+bool WriteMeshPackage(const std::string& path, const CookedMesh& mesh)
+{
+    MeshPackageHeader header = mesh.header;
+    header.magic = MESH_PACKAGE_MAGIC;
+    header.version = MESH_PACKAGE_VERSION;
+    header.vertexCount = static_cast<uint32_t>(mesh.vertices.size());
+    header.indexCount = static_cast<uint32_t>(mesh.indices.size());
+    header.meshletCount = static_cast<uint32_t>(mesh.meshlets.meshlets.size());
+    header.meshletVertexCount = static_cast<uint32_t>(mesh.meshlets.vertices.size());
+    header.meshletTriangleCount = static_cast<uint32_t>(mesh.meshlets.triangles.size() / 3);
+    header.vertexStride = sizeof(PackedVertex);
+
+    header.vertexOffset = AlignOffset(sizeof(MeshPackageHeader));
+    header.indexOffset = AlignOffset(header.vertexOffset + mesh.vertices.size() * sizeof(PackedVertex));
+    header.meshletOffset = AlignOffset(header.indexOffset + mesh.indices.size() * sizeof(uint32_t));
+    header.meshletVertexOffset = AlignOffset(header.meshletOffset + mesh.meshlets.meshlets.size() * sizeof(MeshletDesc));
+    header.meshletTriangleOffset = AlignOffset(header.meshletVertexOffset + mesh.meshlets.vertices.size() * sizeof(uint32_t));
+
+    // Write next to the target and rename, so an interrupted cook never leaves a package
+    // whose header claims it is up to date.
+    const std::string tempPath = path + ".tmp";
+    bool written = false;
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) return false;
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        WriteSection(file, header.vertexOffset, mesh.vertices);
+        WriteSection(file, header.indexOffset, mesh.indices);
+        WriteSection(file, header.meshletOffset, mesh.meshlets.meshlets);
+        WriteSection(file, header.meshletVertexOffset, mesh.meshlets.vertices);
+        WriteSection(file, header.meshletTriangleOffset, mesh.meshlets.triangles);
+        file.close();
+        written = static_cast<bool>(file);
+    }
+
+    std::error_code ec;
+    if (written) {
+        std::filesystem::rename(tempPath, path, ec);
+        if (!ec) return true;
+    }
+    // Never leave a partial package behind; the next cook starts from scratch either way.
+    std::filesystem::remove(tempPath, ec);
+    return false;
+}
+
+std::optional<MeshPackageHeader> ReadMeshPackageHeader(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) return std::nullopt;
+
+    MeshPackageHeader header{};
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!file || header.magic != MESH_PACKAGE_MAGIC || header.version != MESH_PACKAGE_VERSION) return std::nullopt;
+    return header;
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <kitsune_mesh_format.h>
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+struct SourceVertex
+{
+	float position[3]{};
+	float normal[3]{};
+	float uv[2]{};
+};
+
+struct SourceMesh
+{
+	std::vector<SourceVertex> vertices;
+	std::vector<uint32_t> indices;
+};
+
+struct MeshletData
+{
+	std::vector<MeshletDesc> meshlets;
+	std::vector<uint32_t> vertices;
+	std::vector<uint8_t> triangles;
+};
+
+struct CookedMesh
+{
+	MeshPackageHeader header{};
+	std::vector<PackedVertex> vertices;
+	std::vector<uint32_t> indices;
+	MeshletData meshlets;
+};
+
+// Loads a Wavefront OBJ as an indexed triangle list. Polygons are fan-triangulated,
+// identical position/uv/normal tuples are merged and missing normals are generated.
+std::optional<SourceMesh> LoadObjMesh(const std::string& path, std::string& error);
+
+// Reorders triangles for the post-transform vertex cache (Forsyth's linear-speed algorithm).
+void OptimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount);
+
+// Reorders vertices by first use so vertex fetch walks memory linearly; drops unused vertices.
+void OptimizeVertexFetch(std::vector<SourceVertex>& vertices, std::vector<uint32_t>& indices);
+
+// Average cache miss ratio (transformed vertices per triangle) for a FIFO cache of `cacheSize`.
+double AnalyzeVertexCache(const std::vector<uint32_t>& indices, uint32_t cacheSize);
+
+// Splits the index buffer, in order, into meshlets with bounding spheres and normal cones.
+MeshletData BuildMeshlets(const std::vector<SourceVertex>& vertices, const std::vector<uint32_t>& indices,
+	uint32_t maxVertices = MESHLET_MAX_VERTICES, uint32_t maxTriangles = MESHLET_MAX_TRIANGLES);
+
+// Quantizes positions to unorm16 within the mesh bounds, normals to octahedral snorm16 and uvs to half floats.
+std::vector<PackedVertex> QuantizeVertices(const std::vector<SourceVertex>& vertices, float boundsMin[3], float boundsMax[3]);
+
+uint16_t FloatToHalf(float value);
+
+bool WriteMeshPackage(const std::string& path, const CookedMesh& mesh);
+std::optional<MeshPackageHeader> ReadMeshPackageHeader(const std::string& path);